@@ -0,0 +1,13 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "FireModeEnumLibrary.generated.h"
+
+UENUM(BlueprintType)
+enum class EFireMode : uint8
+{
+	EFM_Hitscan UMETA(DisplayName = "Hitscan"),
+	EFM_Ballistic UMETA(DisplayName = "Ballistic"),
+
+	EFM_MAX UMETA(DisplayName = "DefaultMAX")
+};
@@ -0,0 +1,14 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HitZoneEnumLibrary.generated.h"
+
+UENUM(BlueprintType)
+enum class EHitZone : uint8
+{
+	EHZ_Body UMETA(DisplayName = "Body"),
+	EHZ_Head UMETA(DisplayName = "Head"),
+	EHZ_Limb UMETA(DisplayName = "Limb"),
+
+	EHZ_MAX UMETA(DisplayName = "DefaultMAX")
+};
@@ -6,23 +6,36 @@
 #include "AI/EnemyAIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Blueprint/UserWidget.h"
+#include "Combat/DamageAccumulatorComponent.h"
+#include "Combat/HitZoneTable.h"
 #include "Components/BoxComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SphereComponent.h"
+#include "Data/ShooterDataCacheSubsystem.h"
+#include "Engine/SkeletalMesh.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Performance/EffectPoolSubsystem.h"
+#include "Performance/TelemetrySubsystem.h"
 #include "Player/ShooterCharacter.h"
+#include "Shooter/Shooter.h"
+#include "UI/HitNumberManager.h"
+#include "UI/ShooterHUD.h"
 #include "Sound/SoundCue.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Damage Events"), STAT_EnemyDamageEvents, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Enemy Bullet Hit"), STAT_EnemyBulletHit, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Enemy Take Damage"), STAT_EnemyTakeDamage, STATGROUP_Shooter);
+
 AEnemy::AEnemy() :
 	Health(100.f),
 	MaxHealth(100.f),
+	HitZoneTable(nullptr),
 	HealthBarDisplayTime(4.f),
 	HitReactTimeMin(0.5f),
 	HitReactTimeMax(0.75f),
 	bCanHitReact(true),
-	HitNumberDestroyTime(1.5f),
 	bStunned(false),
 	StunChance(0.5f),
 	bCanAttack(true),
@@ -35,13 +48,21 @@ AEnemy::AEnemy() :
 	RightWeaponSocket(TEXT("FX_Trail_R_01")),
 	BaseDamage(20.f),
 	bDying(false),
-	DeathTime(4.f)
+	DeathTime(4.f),
+	AnimUpdateRateScreenSizes({ 0.4f, 0.2f, 0.1f }),
+	NonRenderedAnimUpdateRate(8),
+	MaxInterpolatedAnimUpdateRate(4)
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing is updated per frame by the enemy itself; the mesh, movement and AI tick on their own
+	PrimaryActorTick.bCanEverTick = false;
 
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
+
+	// Far and hidden enemies update their animation less often
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &AEnemy::SetupAnimUpdateRateParams);
 	
 	// Create the Agro Sphere 
 	AgrosSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Agro Sphere"));
@@ -56,6 +77,9 @@ AEnemy::AEnemy() :
 	LeftWeaponCollision->SetupAttachment(GetMesh(), FName("LeftWeaponBone"));
 	RightWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("Right Weapon Box"));
 	RightWeaponCollision->SetupAttachment(GetMesh(), FName("RightWeaponBone"));
+
+	DamageAccumulator = CreateDefaultSubobject<UDamageAccumulatorComponent>(TEXT("Damage Accumulator"));
+	DamageAccumulator->OnDamageResolved.BindUObject(this, &AEnemy::ResolveAccumulatedDamage);
 }
 
 // Called when the game starts or when spawned
@@ -96,6 +120,36 @@ void AEnemy::BeginPlay()
 		EnemyAIController->GetBlackBoardComponent()->SetValueAsBool(TEXT("CanAttack"), true);
 		EnemyAIController->RunBehaviorTree(BehaviorTree);
 	}
+
+	if (UTelemetrySubsystem* TelemetrySubsystem = GetWorld()->GetSubsystem<UTelemetrySubsystem>())
+	{
+		TelemetrySubsystem->RegisterEnemy(this);
+	}
+
+	// The table only depends on the class defaults and the mesh, so the first enemy of the class with the mesh builds it for all
+	const UShooterDataCacheSubsystem* DataCache = UShooterDataCacheSubsystem::Get(this);
+	if (DataCache)
+	{
+		const USkeletalMesh* SkeletalMesh = GetMesh()->SkeletalMesh;
+		const UPhysicsAsset* PhysicsAsset = GetMesh()->GetPhysicsAsset();
+		HitZoneTable = &DataCache->GetHitZoneTable(GetClass(), SkeletalMesh, PhysicsAsset, [this, SkeletalMesh, PhysicsAsset](FHitZoneTable& Table)
+		{
+			const AEnemy* EnemyDefaults = GetClass()->GetDefaultObject<AEnemy>();
+			TMap<FName, EHitZone> ZoneBones = EnemyDefaults->HitZoneBones;
+			const FName HeadBoneName(*EnemyDefaults->HeadBone);
+			if (!HeadBoneName.IsNone() && !ZoneBones.Contains(HeadBoneName))
+			{
+				ZoneBones.Add(HeadBoneName, EHitZone::EHZ_Head);
+			}
+
+			Table.Build(PhysicsAsset, SkeletalMesh ? SkeletalMesh->GetRefSkeleton() : FReferenceSkeleton(), ZoneBones);
+		});
+	}
+}
+
+EHitZone AEnemy::GetHitZone(const FHitResult& HitResult) const
+{
+	return HitZoneTable ? HitZoneTable->GetZone(HitResult) : EHitZone::EHZ_Body;
 }
 
 void AEnemy::AgroSphereBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -181,8 +235,12 @@ void AEnemy::SpawnBlood(const AShooterCharacter* const ShooterCharacter, const F
 		return;
 	}
 	
-	const FTransform SocketTransform = TipSocket->GetSocketTransform(GetMesh());
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ShooterCharacter->GetBloodParticles(), SocketTransform);
+	UEffectPoolSubsystem* const EffectPoolSubsystem = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if (EffectPoolSubsystem)
+	{
+		const FTransform SocketTransform = TipSocket->GetSocketTransform(GetMesh());
+		EffectPoolSubsystem->SpawnEffect(ShooterCharacter->GetBloodParticles(), SocketTransform);
+	}
 }
 
 void AEnemy::StunCharacter(AShooterCharacter* const ShooterCharacter)
@@ -223,55 +281,66 @@ void AEnemy::ShowHeathBar_Implementation()
 	GetWorldTimerManager().SetTimer(HealthBarTimer, this, &AEnemy::HideHealthBar, HealthBarDisplayTime);
 }
 
-void AEnemy::Tick(float DeltaTime)
+void AEnemy::SpawnHitNumber(const int32 Damage, const FVector HitLocation, const bool bHeadShot)
 {
-	Super::Tick(DeltaTime);
+	if (DamageAccumulator && UDamageAccumulatorComponent::IsAccumulationEnabled() && !DamageAccumulator->KeepsPerHitNumbers())
+	{
+		DamageAccumulator->AddHitNumber(Damage, HitLocation, bHeadShot);
+		return;
+	}
 
-	UpdateHitNumbers();
+	DisplayHitNumber(Damage, HitLocation, bHeadShot);
 }
 
-void AEnemy::UpdateHitNumbers() const 
+void AEnemy::StoreHitNumber(UUserWidget* HitNumber, const FVector Location)
 {
-	for (const auto& HitPair : HitNumbers)
+	if (UHitNumberManager* HitNumberManager = GetHitNumberManager())
 	{
-		UUserWidget* HitNumber = HitPair.Key;
-		const FVector Location = HitPair.Value;
-		FVector2D ScreenPosition;
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), Location, ScreenPosition);
-		
-		HitNumber->SetPositionInViewport(ScreenPosition);
+		HitNumberManager->AddBlueprintHitNumber(HitNumber, Location);
+	}
+	else if (HitNumber)
+	{
+		HitNumber->RemoveFromParent();
 	}
 }
 
-void AEnemy::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController)
+void AEnemy::DisplayHitNumber(const int32 Damage, const FVector& HitLocation, const bool bHeadShot)
 {
-	IBulletHitInterface::BulletHit_Implementation(HitResult, Shooter, ShooterController);
-
-	if (ImpactSound)
+	UHitNumberManager* HitNumberManager = GetHitNumberManager();
+	if (HitNumberManager && HitNumberManager->UsesPooledWidgets())
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+		HitNumberManager->ShowHitNumber(Damage, HitLocation, bHeadShot);
 	}
-
-	if (ImpactParticles)
+	else
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location, FRotator(0.f), true);
+		// The blueprint creates the widget and hands it back through StoreHitNumber
+		ShowHitNumber(Damage, HitLocation, bHeadShot);
 	}
 }
 
-void AEnemy::StoreHitNumber(UUserWidget* HitNumber, const FVector Location)
+UHitNumberManager* AEnemy::GetHitNumberManager() const
 {
-	HitNumbers.Add(HitNumber, Location);
-	
-	FTimerDelegate HitNumberDelegate;
-	HitNumberDelegate.BindUFunction(this, FName("DestroyHitNumber"), HitNumber);
-	FTimerHandle HitNumberTimer;
-	GetWorld()->GetTimerManager().SetTimer(HitNumberTimer, HitNumberDelegate, HitNumberDestroyTime, false);
+	const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0);
+	const AShooterHUD* ShooterHUD = PlayerController ? PlayerController->GetHUD<AShooterHUD>() : nullptr;
+	return ShooterHUD ? ShooterHUD->GetHitNumberManager() : nullptr;
 }
 
-void AEnemy::DestroyHitNumber(UUserWidget* HitNumber)
+void AEnemy::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController)
 {
-	HitNumbers.Remove(HitNumber);
-	HitNumber->RemoveFromParent();
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyBulletHit);
+
+	IBulletHitInterface::BulletHit_Implementation(HitResult, Shooter, ShooterController);
+
+	if (ImpactSound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+	}
+
+	UEffectPoolSubsystem* const EffectPoolSubsystem = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if (ImpactParticles && EffectPoolSubsystem)
+	{
+		EffectPoolSubsystem->SpawnEffectAtLocation(ImpactParticles, HitResult.Location);
+	}
 }
 
 void AEnemy::PlayAttackMontage(const FName Section, const float PlayRate)
@@ -336,8 +405,49 @@ FName AEnemy::GetAttackSectionName() const
 	return SectionName;
 }
 
+void AEnemy::SetupAnimUpdateRateParams(FAnimUpdateRateParameters* Params) const
+{
+	Params->bShouldUseLodMap = false;
+	Params->BaseVisibleDistanceFactorThesholds = AnimUpdateRateScreenSizes;
+	Params->BaseNonRenderedUpdateRate = NonRenderedAnimUpdateRate;
+	Params->MaxEvalRateForInterpolation = MaxInterpolatedAnimUpdateRate;
+	Params->bInterpolateSkippedFrames = true;
+}
+
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	INC_DWORD_STAT(STAT_EnemyDamageEvents);
+	UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_DamageEvent, DamageAmount);
+
+	if (DamageAccumulator && UDamageAccumulatorComponent::IsAccumulationEnabled())
+	{
+		DamageAccumulator->AddDamage(DamageAmount, EventInstigator, DamageCauser);
+	}
+	else
+	{
+		ApplyDamageTaken(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
+	}
+
+	return DamageAmount;
+}
+
+void AEnemy::ResolveAccumulatedDamage(const FAccumulatedDamage& AccumulatedDamage)
+{
+	if (AccumulatedDamage.Hits > 0)
+	{
+		ApplyDamageTaken(AccumulatedDamage.Damage, FDamageEvent(UDamageType::StaticClass()), AccumulatedDamage.EventInstigator.Get(), AccumulatedDamage.DamageCauser.Get());
+	}
+
+	if (AccumulatedDamage.HitNumberDamage > 0)
+	{
+		DisplayHitNumber(AccumulatedDamage.HitNumberDamage, AccumulatedDamage.HitNumberLocation, AccumulatedDamage.bHeadShot);
+	}
+}
+
+void AEnemy::ApplyDamageTaken(const float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyTakeDamage);
+
 	Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 
 	// Set the Target Blackboard Key to agro the Character
@@ -358,7 +468,7 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 
 	if (bDying)
 	{
-		return DamageAmount;
+		return;
 	}
 	
 	ShowHeathBar();
@@ -371,8 +481,6 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 		PlayHitMontage(FName("HitReactFront"));
 		SetStunned(true);
 	}
-	
-	return DamageAmount;
 }
 
 void AEnemy::Die()
@@ -4,18 +4,76 @@
 #include "AI/EnemyAnimInstance.h"
 
 #include "AI/Enemy.h"
+#include "Player/ShooterAnimInstance.h"
+#include "Shooter/Shooter.h"
 
-void UGruxAnimInstance::UpdateAnimationProperties(const float DeltaTime)
+DECLARE_CYCLE_STAT(TEXT("Grux Anim Game Thread Update"), STAT_GruxAnimGameThreadUpdate, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Grux Anim Worker Update"), STAT_GruxAnimWorkerUpdate, STATGROUP_Shooter);
+
+FGruxAnimInstanceProxy::FGruxAnimInstanceProxy(UAnimInstance* InAnimInstance) :
+	FAnimInstanceProxy(InAnimInstance),
+	Velocity(FVector::ZeroVector),
+	bHasSnapshot(false)
+{
+	
+}
+
+void FGruxAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
-	if (Enemy == nullptr)
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const UGruxAnimInstance* GruxAnimInstance = Cast<UGruxAnimInstance>(InAnimInstance);
+	bHasSnapshot = GruxAnimInstance && GruxAnimInstance->Enemy && UShooterAnimInstance::IsThreadSafeUpdateEnabled();
+	if (bHasSnapshot)
 	{
-		Enemy = Cast<AEnemy>(TryGetPawnOwner());
+		Velocity = GruxAnimInstance->Enemy->GetVelocity();
 	}
+}
 
-	if (Enemy)
+void FGruxAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	FAnimInstanceProxy::Update(DeltaSeconds);
+
+	UGruxAnimInstance* GruxAnimInstance = Cast<UGruxAnimInstance>(GetAnimInstanceObject());
+	if (bHasSnapshot && GruxAnimInstance)
 	{
-		FVector Velocity = Enemy->GetVelocity();
-		Velocity.Z = 0.f;
-		Speed = Velocity.Size();
+		SHOOTER_SCOPE_CYCLE_COUNTER(STAT_GruxAnimWorkerUpdate);
+		GruxAnimInstance->UpdateFromVelocity(Velocity);
 	}
 }
+
+UGruxAnimInstance::UGruxAnimInstance() :
+	Enemy(nullptr),
+	Speed(0.f)
+{
+	
+}
+
+void UGruxAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	Enemy = Cast<AEnemy>(TryGetPawnOwner());
+}
+
+FAnimInstanceProxy* UGruxAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FGruxAnimInstanceProxy(this);
+}
+
+void UGruxAnimInstance::UpdateAnimationProperties(const float DeltaTime)
+{
+	// FGruxAnimInstanceProxy does the update on a worker thread instead
+	if (Enemy == nullptr || UShooterAnimInstance::IsThreadSafeUpdateEnabled())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_GruxAnimGameThreadUpdate);
+	UpdateFromVelocity(Enemy->GetVelocity());
+}
+
+void UGruxAnimInstance::UpdateFromVelocity(const FVector& Velocity)
+{
+	Speed = FVector(Velocity.X, Velocity.Y, 0.f).Size();
+}
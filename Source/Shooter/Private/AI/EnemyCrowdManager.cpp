@@ -0,0 +1,260 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/AI/EnemyCrowdManager.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/AI/Enemy.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Crowd Agents"), STAT_CrowdAgents, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Crowd Promoted Enemies"), STAT_CrowdPromoted, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Crowd Update Agents"), STAT_CrowdUpdateAgents, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Crowd Promotions"), STAT_CrowdPromotions, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Crowd Instance Upload"), STAT_CrowdInstanceUpload, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarCrowdParallelUpdate(
+	TEXT("Shooter.Crowd.ParallelUpdate"),
+	1,
+	TEXT("When non-zero, crowd agents are updated in parallel on worker threads."));
+
+namespace EnemyCrowd
+{
+	/** Custom data slots read by the crowd vertex animation material. */
+	constexpr int32 AnimationIndexSlot = 0;
+	constexpr int32 AnimationTimeOffsetSlot = 1;
+	constexpr int32 NumCustomDataFloats = 2;
+}
+
+AEnemyCrowdManager::AEnemyCrowdManager() :
+	InitialCrowdSize(0),
+	SpawnRadius(5000.f),
+	PromoteRadius(2500.f),
+	DemoteRadius(3000.f),
+	MaxPromotedEnemies(32),
+	MaxPromotionsPerFrame(4),
+	ChaseRadius(8000.f),
+	MoveSpeed(300.f),
+	DefaultHealth(100.f)
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	CrowdMeshComponent = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Crowd Mesh"));
+	SetRootComponent(CrowdMeshComponent);
+	CrowdMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CrowdMeshComponent->SetCastShadow(false);
+	CrowdMeshComponent->NumCustomDataFloats = EnemyCrowd::NumCustomDataFloats;
+}
+
+void AEnemyCrowdManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Instances are placed in world space
+	CrowdMeshComponent->SetWorldTransform(FTransform::Identity);
+
+	if (EnemyClass)
+	{
+		DefaultHealth = EnemyClass->GetDefaultObject<AEnemy>()->GetMaxHealth();
+	}
+
+	for (int32 Index = 0; Index < InitialCrowdSize; ++Index)
+	{
+		const FVector2D Offset = FMath::RandPointInCircle(SpawnRadius);
+		AddAgent(GetActorLocation() + FVector(Offset, 0.f));
+	}
+}
+
+void AEnemyCrowdManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_CrowdAgents, Positions.Num());
+	DEC_DWORD_STAT_BY(STAT_CrowdPromoted, PromotedEnemies.Num());
+
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 AEnemyCrowdManager::AddAgent(const FVector& Location)
+{
+	const int32 AgentIndex = Positions.Add(Location);
+	Yaws.Add(FMath::FRandRange(0.f, 360.f));
+	Healths.Add(DefaultHealth);
+	States.Add(ECrowdAgentState::ECAS_Idle);
+	WantsPromotion.Add(false);
+	InstanceAnimationStates.Add(ECrowdAgentState::ECAS_MAX);
+
+	const FTransform Transform(FRotator(0.f, Yaws[AgentIndex], 0.f), Location);
+	InstanceTransforms.Add(Transform);
+	CrowdMeshComponent->AddInstanceWorldSpace(Transform);
+
+	// Offset the animation so agents do not walk in lockstep
+	CrowdMeshComponent->SetCustomDataValue(AgentIndex, EnemyCrowd::AnimationTimeOffsetSlot, FMath::FRand(), false);
+	SetInstanceAnimation(AgentIndex, ECrowdAgentState::ECAS_Idle);
+
+	INC_DWORD_STAT(STAT_CrowdAgents);
+	return AgentIndex;
+}
+
+void AEnemyCrowdManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (PlayerPawn == nullptr || Positions.Num() == 0)
+	{
+		return;
+	}
+	const FVector PlayerLocation = PlayerPawn->GetActorLocation();
+
+	// Promoted agents follow their actor, so check them before moving the rest
+	UpdatePromotions(PlayerLocation);
+	UpdateAgents(PlayerLocation, DeltaTime);
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_CrowdInstanceUpload);
+	CrowdMeshComponent->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+}
+
+void AEnemyCrowdManager::UpdateAgents(const FVector& PlayerLocation, const float DeltaTime)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_CrowdUpdateAgents);
+
+	const float PromoteRadiusSquared = FMath::Square(PromoteRadius);
+	const float ChaseRadiusSquared = FMath::Square(ChaseRadius);
+	const float StopDistanceSquared = FMath::Square(PromoteRadius * 0.5f);
+	const float Step = MoveSpeed * DeltaTime;
+
+	const bool bForceSingleThread = CVarCrowdParallelUpdate.GetValueOnGameThread() == 0;
+	ParallelFor(Positions.Num(), [&](const int32 Index)
+	{
+		const ECrowdAgentState State = States[Index];
+		if (State == ECrowdAgentState::ECAS_Promoted || State == ECrowdAgentState::ECAS_Dead)
+		{
+			// Collapse the instance so it is not drawn
+			InstanceTransforms[Index].SetScale3D(FVector::ZeroVector);
+			WantsPromotion[Index] = false;
+			return;
+		}
+
+		FVector& Position = Positions[Index];
+		const FVector ToPlayer = FVector(PlayerLocation.X - Position.X, PlayerLocation.Y - Position.Y, 0.f);
+		const float DistanceSquared = ToPlayer.SizeSquared();
+
+		if (DistanceSquared < ChaseRadiusSquared && DistanceSquared > StopDistanceSquared)
+		{
+			const FVector Direction = ToPlayer * FMath::InvSqrt(DistanceSquared);
+			Position += Direction * Step;
+			Yaws[Index] = FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X));
+			States[Index] = ECrowdAgentState::ECAS_Chasing;
+		}
+		else
+		{
+			States[Index] = ECrowdAgentState::ECAS_Idle;
+		}
+
+		WantsPromotion[Index] = DistanceSquared < PromoteRadiusSquared;
+		InstanceTransforms[Index] = FTransform(FRotator(0.f, Yaws[Index], 0.f), Position);
+	}, bForceSingleThread);
+
+	// Custom data can only be written from the game thread
+	for (int32 Index = 0; Index < States.Num(); ++Index)
+	{
+		if (InstanceAnimationStates[Index] != States[Index])
+		{
+			SetInstanceAnimation(Index, States[Index]);
+		}
+	}
+}
+
+void AEnemyCrowdManager::UpdatePromotions(const FVector& PlayerLocation)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_CrowdPromotions);
+
+	const float DemoteRadiusSquared = FMath::Square(DemoteRadius);
+
+	for (auto It = PromotedEnemies.CreateIterator(); It; ++It)
+	{
+		const int32 AgentIndex = It.Key();
+		AEnemy* Enemy = It.Value().Get();
+		if (Enemy == nullptr || Enemy->IsPendingKill())
+		{
+			// Killed while promoted
+			States[AgentIndex] = ECrowdAgentState::ECAS_Dead;
+			Healths[AgentIndex] = 0.f;
+			It.RemoveCurrent();
+			DEC_DWORD_STAT(STAT_CrowdPromoted);
+			continue;
+		}
+
+		Positions[AgentIndex] = Enemy->GetActorLocation();
+		Yaws[AgentIndex] = Enemy->GetActorRotation().Yaw;
+
+		if (!Enemy->IsDying() && FVector::DistSquared2D(Positions[AgentIndex], PlayerLocation) > DemoteRadiusSquared)
+		{
+			DemoteAgent(AgentIndex, Enemy);
+			It.RemoveCurrent();
+			DEC_DWORD_STAT(STAT_CrowdPromoted);
+		}
+	}
+
+	// WantsPromotion is from the previous update, which is at most a frame old
+	int32 PromotionsLeft = MaxPromotionsPerFrame;
+	for (int32 AgentIndex = 0; AgentIndex < WantsPromotion.Num() && PromotionsLeft > 0; ++AgentIndex)
+	{
+		if (PromotedEnemies.Num() >= MaxPromotedEnemies)
+		{
+			break;
+		}
+
+		if (WantsPromotion[AgentIndex] && PromoteAgent(AgentIndex))
+		{
+			WantsPromotion[AgentIndex] = false;
+			--PromotionsLeft;
+		}
+	}
+}
+
+bool AEnemyCrowdManager::PromoteAgent(const int32 AgentIndex)
+{
+	if (EnemyClass == nullptr)
+	{
+		return false;
+	}
+
+	const FTransform SpawnTransform(FRotator(0.f, Yaws[AgentIndex], 0.f), Positions[AgentIndex]);
+	AEnemy* Enemy = GetWorld()->SpawnActorDeferred<AEnemy>(EnemyClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (Enemy == nullptr)
+	{
+		return false;
+	}
+
+	// Spawned pawns only get their AI controller when asked to
+	Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+	Enemy->SetHealth(Healths[AgentIndex]);
+	UGameplayStatics::FinishSpawningActor(Enemy, SpawnTransform);
+
+	States[AgentIndex] = ECrowdAgentState::ECAS_Promoted;
+	PromotedEnemies.Add(AgentIndex, Enemy);
+	INC_DWORD_STAT(STAT_CrowdPromoted);
+	return true;
+}
+
+void AEnemyCrowdManager::DemoteAgent(const int32 AgentIndex, AEnemy* Enemy)
+{
+	Healths[AgentIndex] = Enemy->GetHealth();
+	States[AgentIndex] = ECrowdAgentState::ECAS_Idle;
+
+	AController* Controller = Enemy->GetController();
+	Enemy->Destroy();
+	if (Controller)
+	{
+		Controller->Destroy();
+	}
+}
+
+void AEnemyCrowdManager::SetInstanceAnimation(const int32 AgentIndex, const ECrowdAgentState State)
+{
+	InstanceAnimationStates[AgentIndex] = State;
+
+	const float AnimationIndex = State == ECrowdAgentState::ECAS_Chasing ? 1.f : 0.f;
+	CrowdMeshComponent->SetCustomDataValue(AgentIndex, EnemyCrowd::AnimationIndexSlot, AnimationIndex, false);
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Animation/AnimCurveHandleCache.h"
+
+#include "Animation/AnimInstance.h"
+#include "Animation/Skeleton.h"
+#include "HAL/IConsoleManager.h"
+#include "Shooter/Shooter.h"
+#include "UObject/UObjectIterator.h"
+
+static FAutoConsoleCommandWithWorldAndArgs AnimCurveBenchmarkCommand(
+	TEXT("Shooter.Anim.CurveBenchmark"),
+	TEXT("Time reading a curve by string name against reading it by cached handle on every anim instance. Arguments: curve name, optional iterations."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Usage: Shooter.Anim.CurveBenchmark <CurveName> [Iterations]"));
+			return;
+		}
+
+		const FString& CurveString = Args[0];
+		const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10000;
+
+		for (TObjectIterator<UAnimInstance> It; It; ++It)
+		{
+			const UAnimInstance* AnimInstance = *It;
+			if (AnimInstance->GetWorld() != World || AnimInstance->IsTemplate())
+			{
+				continue;
+			}
+
+			FAnimCurveHandleCache CurveCache;
+			const int32 Handle = CurveCache.Resolve(AnimInstance, FName(*CurveString));
+
+			// Sum the values so the reads are not optimized away
+			float Sum = 0.f;
+
+			double StartSeconds = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Iterations; ++Index)
+			{
+				Sum += AnimInstance->GetCurveValue(FName(*CurveString));
+			}
+			const double NameSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+			StartSeconds = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Iterations; ++Index)
+			{
+				Sum += CurveCache.GetValue(AnimInstance, Handle);
+			}
+			const double HandleSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+			UE_LOG(LogShooter, Log, TEXT("%s %s: by name %.1f ns, by handle %.1f ns per read (%s skeleton, checksum %f)"),
+				*AnimInstance->GetName(),
+				*CurveString,
+				NameSeconds * 1000000000.0 / Iterations,
+				HandleSeconds * 1000000000.0 / Iterations,
+				CurveCache.IsOnSkeleton(Handle) ? TEXT("on") : TEXT("not on"),
+				Sum);
+		}
+	}));
+
+int32 FAnimCurveHandleCache::Resolve(const UAnimInstance* AnimInstance, const FName CurveName)
+{
+	const int32 ExistingHandle = CurveNames.IndexOfByKey(CurveName);
+	if (ExistingHandle != INDEX_NONE)
+	{
+		return ExistingHandle;
+	}
+
+	const USkeleton* Skeleton = AnimInstance ? AnimInstance->CurrentSkeleton : nullptr;
+	const SmartName::UID_Type CurveUID = Skeleton ? Skeleton->GetUIDByName(USkeleton::AnimCurveMappingName, CurveName) : SmartName::MaxUID;
+	if (Skeleton && CurveUID == SmartName::MaxUID)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Curve %s is not on skeleton %s; %s will read its default value."),
+			*CurveName.ToString(), *Skeleton->GetName(), *GetNameSafe(AnimInstance));
+	}
+
+	CurveUIDs.Add(CurveUID);
+	return CurveNames.Add(CurveName);
+}
+
+float FAnimCurveHandleCache::GetValue(const UAnimInstance* AnimInstance, const int32 Handle, const float DefaultValue) const
+{
+	if (AnimInstance == nullptr || !IsOnSkeleton(Handle))
+	{
+		return DefaultValue;
+	}
+
+	const float* Value = AnimInstance->GetAnimationCurveList(EAnimCurveType::AttributeCurve).Find(CurveNames[Handle]);
+	return Value ? *Value : DefaultValue;
+}
+
+void FAnimCurveHandleCache::Reset()
+{
+	CurveNames.Reset();
+	CurveUIDs.Reset();
+}
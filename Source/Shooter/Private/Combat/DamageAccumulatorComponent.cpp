@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Combat/DamageAccumulatorComponent.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Shooter/Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Hits Accumulated"), STAT_DamageHitsAccumulated, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Resolved"), STAT_DamageEventsResolved, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Collapsed"), STAT_DamageEventsCollapsed, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Numbers Collapsed"), STAT_HitNumbersCollapsed, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarDamageAccumulate(
+	TEXT("Shooter.Damage.Accumulate"),
+	1,
+	TEXT("When non-zero, the hits an actor with a damage accumulator takes in a frame are resolved once at the end of the frame."));
+
+UDamageAccumulatorComponent::UDamageAccumulatorComponent() :
+	bKeepPerHitNumbers(false)
+{
+	// Resolution is driven by the end of frame delegate, only while hits are pending
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+bool UDamageAccumulatorComponent::IsAccumulationEnabled()
+{
+	return CVarDamageAccumulate.GetValueOnGameThread() != 0;
+}
+
+void UDamageAccumulatorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnbindPostActorTick();
+	Pending = FAccumulatedDamage();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDamageAccumulatorComponent::AddDamage(const float DamageAmount, AController* EventInstigator, AActor* DamageCauser)
+{
+	INC_DWORD_STAT(STAT_DamageHitsAccumulated);
+
+	Pending.Damage += DamageAmount;
+	Pending.EventInstigator = EventInstigator;
+	Pending.DamageCauser = DamageCauser;
+	++Pending.Hits;
+
+	BindPostActorTick();
+}
+
+void UDamageAccumulatorComponent::AddHitNumber(const int32 Damage, const FVector& Location, const bool bHeadShot)
+{
+	if (Pending.HitNumberDamage > 0)
+	{
+		INC_DWORD_STAT(STAT_HitNumbersCollapsed);
+	}
+
+	Pending.HitNumberDamage += Damage;
+	Pending.HitNumberLocation = Location;
+	Pending.bHeadShot |= bHeadShot;
+
+	BindPostActorTick();
+}
+
+void UDamageAccumulatorComponent::BindPostActorTick()
+{
+	if (!PostActorTickHandle.IsValid())
+	{
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UDamageAccumulatorComponent::OnWorldPostActorTick);
+	}
+}
+
+void UDamageAccumulatorComponent::UnbindPostActorTick()
+{
+	if (PostActorTickHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+		PostActorTickHandle.Reset();
+	}
+}
+
+void UDamageAccumulatorComponent::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	UnbindPostActorTick();
+
+	// Resolving can add hits again, e.g. when the owner dies next to an explosive
+	const FAccumulatedDamage Resolved = Pending;
+	Pending = FAccumulatedDamage();
+
+	INC_DWORD_STAT(STAT_DamageEventsResolved);
+	INC_DWORD_STAT_BY(STAT_DamageEventsCollapsed, FMath::Max(0, Resolved.Hits - 1));
+
+	OnDamageResolved.ExecuteIfBound(Resolved);
+}
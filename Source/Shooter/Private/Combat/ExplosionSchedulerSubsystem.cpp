@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Combat/ExplosionSchedulerSubsystem.h"
+
+#include "Engine/World.h"
+#include "Explosive.h"
+#include "Kismet/GameplayStatics.h"
+#include "Performance/EffectPoolSubsystem.h"
+#include "Shooter/Shooter.h"
+#include "Sound/SoundCue.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detonations Queued"), STAT_DetonationsQueued, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Detonations Deferred"), STAT_DetonationsDeferred, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explode Sounds Skipped"), STAT_ExplodeSoundsSkipped, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Damage Events"), STAT_ExplosionDamageEvents, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Damage Events Merged"), STAT_ExplosionDamageEventsMerged, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Explosion Scheduler"), STAT_ExplosionScheduler, STATGROUP_Shooter);
+
+namespace ExplosionScheduler
+{
+	/** Orders the queue heap by detonation time. */
+	struct FDetonationTimePredicate
+	{
+		FORCEINLINE bool operator()(const FScheduledDetonation& A, const FScheduledDetonation& B) const
+		{
+			return A.DetonationTime < B.DetonationTime;
+		}
+	};
+}
+
+UExplosionSchedulerSubsystem::UExplosionSchedulerSubsystem() :
+	MaxDetonationsPerFrame(4),
+	MaxSoundsPerFrame(2),
+	MinChainDelay(0.1f),
+	MaxChainDelay(0.25f),
+	NextChainId(0),
+	SoundsThisFrame(0)
+{
+
+}
+
+void UExplosionSchedulerSubsystem::Deinitialize()
+{
+	Queue.Empty();
+	Chains.Empty();
+	PendingDamage.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UExplosionSchedulerSubsystem::IsTickable() const
+{
+	return Queue.Num() > 0;
+}
+
+ETickableTickType UExplosionSchedulerSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UExplosionSchedulerSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UExplosionSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UExplosionSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+void UExplosionSchedulerSubsystem::QueueDetonation(AExplosive* Explosive, AActor* Shooter, AController* ShooterController, const FVector& EffectLocation)
+{
+	if (Explosive == nullptr || Explosive->IsPrimed())
+	{
+		return;
+	}
+
+	const int32 ChainId = NextChainId++;
+	Chains.Add(ChainId);
+	Schedule(Explosive, Shooter, ShooterController, EffectLocation, 0.f, ChainId);
+}
+
+void UExplosionSchedulerSubsystem::Schedule(AExplosive* Explosive, AActor* Shooter, AController* ShooterController, const FVector& EffectLocation, const float Delay, const int32 ChainId)
+{
+	Explosive->Prime();
+
+	FScheduledDetonation Detonation;
+	Detonation.Explosive = Explosive;
+	Detonation.Shooter = Shooter;
+	Detonation.ShooterController = ShooterController;
+	Detonation.EffectLocation = EffectLocation;
+	Detonation.DetonationTime = GetWorld()->GetTimeSeconds() + Delay;
+	Detonation.ChainId = ChainId;
+	Queue.HeapPush(Detonation, ExplosionScheduler::FDetonationTimePredicate());
+
+	++Chains.FindChecked(ChainId).PendingDetonations;
+	INC_DWORD_STAT(STAT_DetonationsQueued);
+}
+
+void UExplosionSchedulerSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ExplosionScheduler);
+
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	SoundsThisFrame = 0;
+	const float Now = World->GetTimeSeconds();
+	int32 Detonated = 0;
+	int32 Deferred = 0;
+	while (Queue.Num() > 0 && Queue.HeapTop().DetonationTime <= Now)
+	{
+		if (Detonated >= MaxDetonationsPerFrame)
+		{
+			// Due detonations left for the next frames
+			for (const FScheduledDetonation& Detonation : Queue)
+			{
+				if (Detonation.DetonationTime <= Now)
+				{
+					++Deferred;
+				}
+			}
+			break;
+		}
+
+		FScheduledDetonation Detonation;
+		Queue.HeapPop(Detonation, ExplosionScheduler::FDetonationTimePredicate(), false);
+
+		Detonate(Detonation);
+		++Detonated;
+
+		FExplosionChain& Chain = Chains.FindChecked(Detonation.ChainId);
+		if (--Chain.PendingDetonations <= 0)
+		{
+			Chains.Remove(Detonation.ChainId);
+		}
+	}
+	SET_DWORD_STAT(STAT_DetonationsDeferred, Deferred);
+
+	ApplyPendingDamage();
+}
+
+void UExplosionSchedulerSubsystem::Detonate(const FScheduledDetonation& Detonation)
+{
+	AExplosive* Explosive = Detonation.Explosive.Get();
+	if (Explosive == nullptr || Explosive->IsActorBeingDestroyed())
+	{
+		return;
+	}
+
+	if (USoundCue* ExplodeSound = Explosive->GetExplodeSound())
+	{
+		// Explosions of a chain overlap anyway, a few sounds per frame are enough
+		if (SoundsThisFrame < MaxSoundsPerFrame)
+		{
+			UGameplayStatics::PlaySoundAtLocation(Explosive, ExplodeSound, Explosive->GetActorLocation());
+			++SoundsThisFrame;
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_ExplodeSoundsSkipped);
+		}
+	}
+
+	UEffectPoolSubsystem* const EffectPoolSubsystem = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if (Explosive->GetExplodeParticles() && EffectPoolSubsystem)
+	{
+		EffectPoolSubsystem->SpawnEffectAtLocation(Explosive->GetExplodeParticles(), Detonation.EffectLocation);
+	}
+
+	FExplosionChain& Chain = Chains.FindChecked(Detonation.ChainId);
+	TArray<AExplosive*> NearbyExplosives;
+	TArray<FExplosiveHit> Hits;
+	Explosive->Explode(Chain.DamagedVictims, NearbyExplosives, Hits);
+
+	for (const FExplosiveHit& Hit : Hits)
+	{
+		FPendingExplosionDamage& VictimDamage = PendingDamage.FindOrAdd(Hit.Victim);
+		if (VictimDamage.Hits++ == 0)
+		{
+			VictimDamage.Shooter = Detonation.Shooter;
+			VictimDamage.ShooterController = Detonation.ShooterController;
+		}
+		VictimDamage.Damage += Hit.Damage;
+	}
+
+	for (AExplosive* NearbyExplosive : NearbyExplosives)
+	{
+		const float Delay = FMath::FRandRange(MinChainDelay, MaxChainDelay);
+		Schedule(NearbyExplosive, Detonation.Shooter.Get(), Detonation.ShooterController.Get(), NearbyExplosive->GetActorLocation(), Delay, Detonation.ChainId);
+	}
+}
+
+void UExplosionSchedulerSubsystem::ApplyPendingDamage()
+{
+	// Damage can kill and destroy actors, so iterate over a copy
+	TMap<TWeakObjectPtr<AActor>, FPendingExplosionDamage> FrameDamage = MoveTemp(PendingDamage);
+	PendingDamage.Reset();
+
+	for (const auto& DamagePair : FrameDamage)
+	{
+		AActor* Victim = DamagePair.Key.Get();
+		const FPendingExplosionDamage& VictimDamage = DamagePair.Value;
+		if (Victim == nullptr)
+		{
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_ExplosionDamageEvents);
+		INC_DWORD_STAT_BY(STAT_ExplosionDamageEventsMerged, VictimDamage.Hits - 1);
+		UGameplayStatics::ApplyDamage(Victim, VictimDamage.Damage, VictimDamage.ShooterController.Get(), VictimDamage.Shooter.Get(), UDamageType::StaticClass());
+	}
+}
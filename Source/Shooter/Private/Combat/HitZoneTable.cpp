@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Combat/HitZoneTable.h"
+
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "ReferenceSkeleton.h"
+
+void FHitZoneTable::Build(const UPhysicsAsset* PhysicsAsset, const FReferenceSkeleton& RefSkeleton, const TMap<FName, EHitZone>& ZoneBones)
+{
+	BodyZones.Reset();
+	BodyBoneNames.Reset();
+	BoneZones = ZoneBones;
+
+	if (PhysicsAsset == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumBodies = PhysicsAsset->SkeletalBodySetups.Num();
+	BodyZones.Reserve(NumBodies);
+	BodyBoneNames.Reserve(NumBodies);
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+	{
+		const FName BoneName = BodySetup ? BodySetup->BoneName : NAME_None;
+
+		EHitZone Zone = EHitZone::EHZ_Body;
+		for (int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName); BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+		{
+			if (const EHitZone* ListedZone = ZoneBones.Find(RefSkeleton.GetBoneName(BoneIndex)))
+			{
+				Zone = *ListedZone;
+				break;
+			}
+		}
+
+		BodyZones.Add(Zone);
+		BodyBoneNames.Add(BoneName);
+		BoneZones.Add(BoneName, Zone);
+	}
+}
+
+EHitZone FHitZoneTable::GetZone(const FHitResult& HitResult) const
+{
+	// Item is the body index for skeletal mesh hits
+	if (BodyZones.IsValidIndex(HitResult.Item) && BodyBoneNames[HitResult.Item] == HitResult.BoneName)
+	{
+		return BodyZones[HitResult.Item];
+	}
+
+	const EHitZone* Zone = BoneZones.Find(HitResult.BoneName);
+	return Zone ? *Zone : EHitZone::EHZ_Body;
+}
@@ -0,0 +1,309 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Combat/HitscanSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "Misc/ScopeExit.h"
+#include "GameFramework/Pawn.h"
+#include "Performance/TelemetrySubsystem.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/Player/ShooterCharacter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots Queued"), STAT_HitscanShotsQueued, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots Resolved"), STAT_HitscanShotsResolved, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Blast Pellets"), STAT_HitscanBlastPellets, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Traces"), STAT_HitscanTraces, STATGROUP_Shooter);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Hitscan Traces Per Shot"), STAT_HitscanTracesPerShot, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hitscan Max Traces Per Shot"), STAT_HitscanMaxTracesPerShot, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Resolve"), STAT_HitscanResolve, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Apply"), STAT_HitscanApply, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarHitscanParallelResolve(
+	TEXT("Shooter.Hitscan.ParallelResolve"),
+	1,
+	TEXT("When non-zero, hitscan traces queued in a frame are resolved in parallel on worker threads."));
+
+static TAutoConsoleVariable<int32> CVarHitscanPenetration(
+	TEXT("Shooter.Hitscan.Penetration"),
+	1,
+	TEXT("When zero, hitscan bullets stop at the first blocking hit instead of going through or ricocheting."));
+
+namespace HitscanSubsystem
+{
+	/** Distance off a surface that traces continuing from it start at, so they do not hit it again. */
+	static constexpr float SurfaceOffset = 0.1f;
+}
+
+UHitscanSubsystem::UHitscanSubsystem() :
+	MaxRetracesPerShot(4),
+	MaxPenetrationDepth(25.f),
+	DefaultPowerLoss(0.5f),
+	PawnPowerLoss(0.4f),
+	RicochetAngle(15.f),
+	RicochetPowerLoss(0.5f)
+{
+
+}
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SurfacePowerLosses.Init(DefaultPowerLoss, SurfaceType_Max);
+	for (const FSurfacePenetration& SurfacePenetration : SurfacePenetrations)
+	{
+		const FPhysicalSurfaceName* SurfaceName = UPhysicsSettings::Get()->PhysicalSurfaces.FindByPredicate([&SurfacePenetration](const FPhysicalSurfaceName& PhysicalSurface)
+		{
+			return PhysicalSurface.Name == SurfacePenetration.Surface;
+		});
+
+		if (SurfaceName)
+		{
+			SurfacePowerLosses[SurfaceName->Type] = SurfacePenetration.PowerLoss;
+		}
+		else
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Hitscan penetration configured for unknown physical surface %s"), *SurfacePenetration.Surface.ToString());
+		}
+	}
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	PendingShots.Empty();
+	ResolvingShots.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UHitscanSubsystem::IsTickable() const
+{
+	return PendingShots.Num() > 0;
+}
+
+ETickableTickType UHitscanSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UHitscanSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+void UHitscanSubsystem::QueueShot(AShooterCharacter* Shooter, const FVector& CrosshairStart, const FVector& CrosshairEnd, const FTransform& MuzzleTransform)
+{
+	FHitscanShot& Shot = PendingShots.AddDefaulted_GetRef();
+	Shot.Shooter = Shooter;
+	Shot.CrosshairStart = CrosshairStart;
+	Shot.CrosshairEnd = CrosshairEnd;
+	Shot.MuzzleTransform = MuzzleTransform;
+
+	INC_DWORD_STAT(STAT_HitscanShotsQueued);
+}
+
+void UHitscanSubsystem::QueueBlast(AShooterCharacter* Shooter, const FVector& CrosshairStart, TArrayView<const FVector> CrosshairEnds, const FTransform& MuzzleTransform)
+{
+	const int32 BlastId = NextBlastId++;
+	const int32 FirstIndex = PendingShots.AddDefaulted(CrosshairEnds.Num());
+	for (int32 PelletIndex = 0; PelletIndex < CrosshairEnds.Num(); ++PelletIndex)
+	{
+		FHitscanShot& Shot = PendingShots[FirstIndex + PelletIndex];
+		Shot.Shooter = Shooter;
+		Shot.CrosshairStart = CrosshairStart;
+		Shot.CrosshairEnd = CrosshairEnds[PelletIndex];
+		Shot.MuzzleTransform = MuzzleTransform;
+		Shot.BlastId = BlastId;
+	}
+
+	INC_DWORD_STAT_BY(STAT_HitscanShotsQueued, CrosshairEnds.Num());
+	INC_DWORD_STAT_BY(STAT_HitscanBlastPellets, CrosshairEnds.Num());
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT
+	{
+		TickSeconds += FPlatformTime::Seconds() - StartSeconds;
+	};
+
+	// Swap so shots queued while applying results are resolved next frame
+	Swap(PendingShots, ResolvingShots);
+	PendingShots.Reset();
+
+	{
+		SHOOTER_SCOPE_CYCLE_COUNTER(STAT_HitscanResolve);
+		
+		// Physics has already been simulated for this frame, so the scene is only read from here on
+		const bool bForceSingleThread = CVarHitscanParallelResolve.GetValueOnGameThread() == 0 || ResolvingShots.Num() < 2;
+		ParallelFor(ResolvingShots.Num(), [this, World](const int32 Index)
+		{
+			ResolveShot(World, ResolvingShots[Index]);
+		}, bForceSingleThread);
+	}
+	INC_DWORD_STAT_BY(STAT_HitscanShotsResolved, ResolvingShots.Num());
+
+	int32 NumTraces = 0;
+	int32 MaxTraces = 0;
+	for (const FHitscanShot& Shot : ResolvingShots)
+	{
+		NumTraces += Shot.NumTraces;
+		MaxTraces = FMath::Max(MaxTraces, Shot.NumTraces);
+	}
+	INC_DWORD_STAT_BY(STAT_HitscanTraces, NumTraces);
+	SET_FLOAT_STAT(STAT_HitscanTracesPerShot, ResolvingShots.Num() > 0 ? static_cast<float>(NumTraces) / ResolvingShots.Num() : 0.f);
+	SET_DWORD_STAT(STAT_HitscanMaxTracesPerShot, MaxTraces);
+	UTelemetrySubsystem::Record(World, ETelemetryEvent::ETE_TraceIssued, NumTraces);
+
+	{
+		SHOOTER_SCOPE_CYCLE_COUNTER(STAT_HitscanApply);
+
+		// Pellets of a blast are queued together, so they are contiguous
+		for (int32 FirstIndex = 0; FirstIndex < ResolvingShots.Num();)
+		{
+			const FHitscanShot& FirstShot = ResolvingShots[FirstIndex];
+			int32 EndIndex = FirstIndex + 1;
+			while (FirstShot.BlastId != INDEX_NONE && EndIndex < ResolvingShots.Num() && ResolvingShots[EndIndex].BlastId == FirstShot.BlastId)
+			{
+				++EndIndex;
+			}
+
+			AShooterCharacter* const Shooter = FirstShot.Shooter.Get();
+			if (Shooter)
+			{
+				Shooter->ApplyHitscanShots(MakeArrayView(ResolvingShots.GetData() + FirstIndex, EndIndex - FirstIndex));
+			}
+			FirstIndex = EndIndex;
+		}
+	}
+
+	ResolvingShots.Reset();
+}
+
+void UHitscanSubsystem::ResolveShot(const UWorld* World, FHitscanShot& Shot) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HitscanTrace));
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	// Trace from crosshair world location outward
+	FVector BeamEndLocation{ Shot.CrosshairEnd };
+	FHitResult CrosshairHitResult;
+	++Shot.NumTraces;
+	if (World->LineTraceSingleByChannel(CrosshairHitResult, Shot.CrosshairStart, Shot.CrosshairEnd, ECollisionChannel::ECC_Visibility, QueryParams))
+	{
+		// Tentative beam location - still need to trace from gun
+		BeamEndLocation = CrosshairHitResult.Location;
+	}
+
+	// Follow the bullet from the gun barrel, through and off what it hits, until it runs out of power, range or traces
+	FVector SegmentStart{ Shot.MuzzleTransform.GetLocation() };
+	const FVector StartToEnd{ BeamEndLocation - SegmentStart };
+	FVector Direction{ StartToEnd.GetSafeNormal() };
+	float Range = StartToEnd.Size() * 1.25f;
+	float Power = 1.f;
+	int32 RetracesLeft = CVarHitscanPenetration.GetValueOnAnyThread() != 0 ? MaxRetracesPerShot : 0;
+	const float RicochetSine = FMath::Sin(FMath::DegreesToRadians(RicochetAngle));
+	bool bFromBarrel = true;
+
+	// Triggers such as enemy agro spheres and pickup areas overlap Visibility; only blocking hits stop or slow the bullet
+	FHitResult SegmentHitResult;
+	for (;;)
+	{
+		const FVector SegmentEnd{ SegmentStart + Direction * Range };
+		++Shot.NumTraces;
+
+		// object between barrel and BeamEndPoint?
+		if (!World->LineTraceSingleByChannel(SegmentHitResult, SegmentStart, SegmentEnd, ECollisionChannel::ECC_Visibility, QueryParams))
+		{
+			Shot.TailStart = SegmentStart;
+			Shot.TailEnd = bFromBarrel ? BeamEndLocation : SegmentEnd;
+			return;
+		}
+		Shot.Impacts.Add({ SegmentHitResult, SegmentStart, Power });
+
+		Range -= SegmentHitResult.Distance;
+		if (RetracesLeft <= 0 || Range <= 0.f)
+		{
+			Shot.bStopped = true;
+			return;
+		}
+
+		// The game thread waits for the batch, so hit actors cannot be destroyed while it is read here
+		const FVector ImpactPoint{ SegmentHitResult.ImpactPoint };
+		const bool bHitPawn = Cast<APawn>(SegmentHitResult.GetActor()) != nullptr;
+		const float GrazingSine = -(Direction | SegmentHitResult.ImpactNormal);
+		if (!bHitPawn && GrazingSine < RicochetSine)
+		{
+			// Grazing hit, bounce off the surface
+			Power -= RicochetPowerLoss;
+			Direction = Direction.MirrorByVector(SegmentHitResult.ImpactNormal);
+			SegmentStart = ImpactPoint + SegmentHitResult.ImpactNormal * HitscanSubsystem::SurfaceOffset;
+		}
+		else if (bHitPawn)
+		{
+			// Go through the whole pawn; every body of it would block the next trace
+			Power -= GetPenetrationPowerLoss(SegmentHitResult);
+			QueryParams.AddIgnoredActor(SegmentHitResult.GetActor());
+			SegmentStart = ImpactPoint;
+		}
+		else
+		{
+			// Find where the bullet leaves the surface by tracing back to the entry point against the hit component only
+			Power -= GetPenetrationPowerLoss(SegmentHitResult);
+			UPrimitiveComponent* const HitComponent = SegmentHitResult.GetComponent();
+			// Going through takes the trace back and the trace onward
+			if (Power <= 0.f || HitComponent == nullptr || RetracesLeft < 2)
+			{
+				Shot.bStopped = true;
+				return;
+			}
+
+			FHitResult ExitHitResult;
+			--RetracesLeft;
+			++Shot.NumTraces;
+			if (!HitComponent->LineTraceComponent(ExitHitResult, ImpactPoint + Direction * MaxPenetrationDepth, ImpactPoint, QueryParams) || ExitHitResult.bStartPenetrating)
+			{
+				// Thicker than MaxPenetrationDepth
+				Shot.bStopped = true;
+				return;
+			}
+
+			Range -= FVector::Dist(ImpactPoint, ExitHitResult.ImpactPoint);
+			SegmentStart = ExitHitResult.ImpactPoint + Direction * HitscanSubsystem::SurfaceOffset;
+		}
+
+		--RetracesLeft;
+		bFromBarrel = false;
+		if (Power <= 0.f)
+		{
+			Shot.bStopped = true;
+			return;
+		}
+	}
+}
+
+float UHitscanSubsystem::GetPenetrationPowerLoss(const FHitResult& HitResult) const
+{
+	if (Cast<APawn>(HitResult.GetActor()))
+	{
+		return PawnPowerLoss;
+	}
+
+	const EPhysicalSurface SurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+	return SurfacePowerLosses.IsValidIndex(SurfaceType) ? SurfacePowerLosses[SurfaceType] : DefaultPowerLoss;
+}
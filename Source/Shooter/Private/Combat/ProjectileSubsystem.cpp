@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Combat/ProjectileSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Combat/HitscanSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/ScopeExit.h"
+#include "Performance/TelemetrySubsystem.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/Items/Weapon.h"
+#include "Shooter/Public/Player/ShooterCharacter.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilesInFlight, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Fired"), STAT_ProjectilesFired, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Hits"), STAT_ProjectileHits, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Projectile Update"), STAT_ProjectileUpdate, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Projectile Apply"), STAT_ProjectileApply, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarProjectileParallelUpdate(
+	TEXT("Shooter.Projectile.ParallelUpdate"),
+	1,
+	TEXT("When non-zero, ballistic bullets are integrated and traced in parallel on worker threads."));
+
+UProjectileSubsystem::UProjectileSubsystem() :
+	MaxProjectiles(4096),
+	ProjectileLifetime(4.f),
+	ZeroingDistance(10000.f),
+	TickSeconds(0.0)
+{
+
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	Positions.Empty();
+	Velocities.Empty();
+	GravityScales.Empty();
+	Lifetimes.Empty();
+	Shooters.Empty();
+	Weapons.Empty();
+	SegmentStarts.Empty();
+	HitResults.Empty();
+	BlockingHits.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UProjectileSubsystem::IsTickable() const
+{
+	return Positions.Num() > 0;
+}
+
+ETickableTickType UProjectileSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UProjectileSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UProjectileSubsystem::FireProjectile(AShooterCharacter* Shooter, AWeapon* Weapon, const FVector& Location, const FVector& Velocity, const float GravityScale)
+{
+	if (Positions.Num() >= MaxProjectiles)
+	{
+		return false;
+	}
+
+	Positions.Add(Location);
+	Velocities.Add(Velocity);
+	GravityScales.Add(GravityScale);
+	Lifetimes.Add(ProjectileLifetime);
+	Shooters.Add(Shooter);
+	Weapons.Add(Weapon);
+
+	INC_DWORD_STAT(STAT_ProjectilesFired);
+	return true;
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT
+	{
+		TickSeconds += FPlatformTime::Seconds() - StartSeconds;
+	};
+
+	const int32 NumProjectiles = Positions.Num();
+	{
+		SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ProjectileUpdate);
+
+		SegmentStarts.SetNumUninitialized(NumProjectiles, false);
+		HitResults.SetNum(NumProjectiles, false);
+		BlockingHits.SetNumUninitialized(NumProjectiles, false);
+
+		// Physics has already been simulated for this frame, so the scene is only read from here on
+		const float GravityZ = World->GetGravityZ();
+		const bool bForceSingleThread = CVarProjectileParallelUpdate.GetValueOnGameThread() == 0 || NumProjectiles < 2;
+		ParallelFor(NumProjectiles, [this, World, DeltaTime, GravityZ](const int32 Index)
+		{
+			UpdateProjectile(World, Index, DeltaTime, GravityZ);
+		}, bForceSingleThread);
+	}
+	UTelemetrySubsystem::Record(World, ETelemetryEvent::ETE_TraceIssued, NumProjectiles);
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ProjectileApply);
+
+	/** Hit of a bullet removed this frame. */
+	struct FProjectileHit
+	{
+		FHitscanShot Shot;
+		TWeakObjectPtr<AWeapon> Weapon;
+	};
+	TArray<FProjectileHit, TInlineAllocator<16>> ProjectileHits;
+
+	// Remove the bullets first, so the hits can fire new bullets safely; backwards, so swapped in bullets are already done
+	for (int32 Index = NumProjectiles - 1; Index >= 0; --Index)
+	{
+		if (BlockingHits[Index])
+		{
+			FProjectileHit& ProjectileHit = ProjectileHits.AddDefaulted_GetRef();
+			ProjectileHit.Shot.Shooter = Shooters[Index];
+			ProjectileHit.Shot.CrosshairStart = SegmentStarts[Index];
+			ProjectileHit.Shot.CrosshairEnd = Positions[Index];
+			ProjectileHit.Shot.MuzzleTransform = FTransform(Velocities[Index].Rotation(), SegmentStarts[Index]);
+			ProjectileHit.Shot.Impacts.Add({ HitResults[Index], SegmentStarts[Index], 1.f });
+			ProjectileHit.Shot.bStopped = true;
+			ProjectileHit.Weapon = Weapons[Index];
+
+			RemoveProjectile(Index);
+		}
+		else if (Lifetimes[Index] <= 0.f)
+		{
+			RemoveProjectile(Index);
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_ProjectileHits, ProjectileHits.Num());
+	SET_DWORD_STAT(STAT_ProjectilesInFlight, Positions.Num());
+
+	// The beam of a hit is drawn along the last segment the bullet travelled
+	for (const FProjectileHit& ProjectileHit : ProjectileHits)
+	{
+		AShooterCharacter* const Shooter = ProjectileHit.Shot.Shooter.Get();
+		AWeapon* const Weapon = ProjectileHit.Weapon.Get();
+		if (Shooter && Weapon)
+		{
+			Shooter->ApplyHitscanShots(MakeArrayView(&ProjectileHit.Shot, 1), Weapon);
+		}
+	}
+}
+
+void UProjectileSubsystem::UpdateProjectile(const UWorld* World, const int32 Index, const float DeltaTime, const float GravityZ)
+{
+	// Semi-implicit Euler; bullets are fast enough for the drop to be accurate at frame rate
+	const FVector Start = Positions[Index];
+	FVector& Velocity = Velocities[Index];
+	Velocity.Z += GravityZ * GravityScales[Index] * DeltaTime;
+	const FVector End = Start + Velocity * DeltaTime;
+
+	SegmentStarts[Index] = Start;
+	Positions[Index] = End;
+	Lifetimes[Index] -= DeltaTime;
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileTrace));
+	BlockingHits[Index] = World->LineTraceSingleByChannel(HitResults[Index], Start, End, ECollisionChannel::ECC_Visibility, QueryParams);
+}
+
+void UProjectileSubsystem::RemoveProjectile(const int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	GravityScales.RemoveAtSwap(Index, 1, false);
+	Lifetimes.RemoveAtSwap(Index, 1, false);
+	Shooters.RemoveAtSwap(Index, 1, false);
+	Weapons.RemoveAtSwap(Index, 1, false);
+}
@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Data/ShooterDataCacheSubsystem.h"
+
+#include "Engine/DataTable.h"
+#include "Engine/GameInstance.h"
+#include "FItemRarityTable.h"
+#include "FWeaponDataTable.h"
+#include "Kismet/GameplayStatics.h"
+#include "Shooter/Shooter.h"
+
+namespace ShooterDataCache
+{
+	/** Weapon table row of every EWeaponType, in enum order. */
+	static const FName WeaponRowNames[] =
+	{
+		TEXT("SubmachineGun"),
+		TEXT("AssaultRifle"),
+		TEXT("Pistol"),
+		TEXT("Shotgun")
+	};
+	static_assert(UE_ARRAY_COUNT(WeaponRowNames) == static_cast<uint8>(EWeaponType::EWT_MAX), "Every EWeaponType needs a weapon table row name.");
+
+	/** Item rarity table row of every EItemRarity, in enum order. */
+	static const FName ItemRarityRowNames[] =
+	{
+		TEXT("Damaged"),
+		TEXT("Common"),
+		TEXT("Uncommon"),
+		TEXT("Rare"),
+		TEXT("Legendary")
+	};
+	static_assert(UE_ARRAY_COUNT(ItemRarityRowNames) == static_cast<uint8>(EItemRarity::EIR_MAX), "Every EItemRarity needs an item rarity table row name.");
+}
+
+UShooterDataCacheSubsystem::UShooterDataCacheSubsystem() :
+	WeaponDataTablePath(FSoftObjectPath(TEXT("/Game/DataTable/Weapon_DataTable.Weapon_DataTable"))),
+	ItemRarityDataTablePath(FSoftObjectPath(TEXT("/Game/DataTable/ItemRarity_DataTable.ItemRarity_DataTable"))),
+	WeaponDataTable(nullptr),
+	ItemRarityDataTable(nullptr)
+{
+
+}
+
+void UShooterDataCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LoadTables();
+}
+
+void UShooterDataCacheSubsystem::Deinitialize()
+{
+	ReleaseTables();
+
+	Super::Deinitialize();
+}
+
+const UShooterDataCacheSubsystem* UShooterDataCacheSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	if (GameInstance)
+	{
+		const UShooterDataCacheSubsystem* DataCache = GameInstance->GetSubsystem<UShooterDataCacheSubsystem>();
+		if (DataCache)
+		{
+			return DataCache;
+		}
+	}
+
+	// Construction scripts in the editor run without a game instance
+	UShooterDataCacheSubsystem* EditorDataCache = GetMutableDefault<UShooterDataCacheSubsystem>();
+	EditorDataCache->LoadTables();
+	return EditorDataCache;
+}
+
+const FWeaponDataTable* UShooterDataCacheSubsystem::GetWeaponData(const EWeaponType WeaponType) const
+{
+	const int32 Index = static_cast<int32>(WeaponType);
+	return WeaponRows.IsValidIndex(Index) ? WeaponRows[Index] : nullptr;
+}
+
+const FItemRarityTable* UShooterDataCacheSubsystem::GetItemRarityData(const EItemRarity ItemRarity) const
+{
+	const int32 Index = static_cast<int32>(ItemRarity);
+	return ItemRarityRows.IsValidIndex(Index) ? ItemRarityRows[Index] : nullptr;
+}
+
+const FHitZoneTable& UShooterDataCacheSubsystem::GetHitZoneTable(const UClass* OwnerClass, const USkeletalMesh* SkeletalMesh, const UPhysicsAsset* PhysicsAsset, TFunctionRef<void(FHitZoneTable&)> Build) const
+{
+	TUniquePtr<FHitZoneTable>& HitZoneTable = HitZoneTables.FindOrAdd(FHitZoneTableKey(OwnerClass, SkeletalMesh, PhysicsAsset));
+	if (!HitZoneTable.IsValid())
+	{
+		HitZoneTable = MakeUnique<FHitZoneTable>();
+		Build(*HitZoneTable);
+	}
+	return *HitZoneTable;
+}
+
+void UShooterDataCacheSubsystem::LoadTables()
+{
+	// Rows are indexed once, even when a table is missing
+	if (WeaponRows.Num() > 0)
+	{
+		return;
+	}
+
+	WeaponDataTable = WeaponDataTablePath.LoadSynchronous();
+	ItemRarityDataTable = ItemRarityDataTablePath.LoadSynchronous();
+	if (WeaponDataTable == nullptr || ItemRarityDataTable == nullptr)
+	{
+		UE_LOG(LogShooter, Error, TEXT("Could not load the weapon (%s) or item rarity (%s) data table."),
+			*WeaponDataTablePath.ToString(), *ItemRarityDataTablePath.ToString());
+	}
+
+#if WITH_EDITOR
+	// Editing a table reallocates its rows
+	if (WeaponDataTable)
+	{
+		WeaponDataTable->OnDataTableChanged().AddUObject(this, &UShooterDataCacheSubsystem::BuildRowIndex);
+	}
+	if (ItemRarityDataTable)
+	{
+		ItemRarityDataTable->OnDataTableChanged().AddUObject(this, &UShooterDataCacheSubsystem::BuildRowIndex);
+	}
+#endif
+
+	BuildRowIndex();
+}
+
+void UShooterDataCacheSubsystem::BuildRowIndex()
+{
+	static const FString ContextString(TEXT("UShooterDataCacheSubsystem"));
+
+	WeaponRows.Init(nullptr, UE_ARRAY_COUNT(ShooterDataCache::WeaponRowNames));
+	if (WeaponDataTable)
+	{
+		for (int32 Index = 0; Index < WeaponRows.Num(); ++Index)
+		{
+			WeaponRows[Index] = WeaponDataTable->FindRow<FWeaponDataTable>(ShooterDataCache::WeaponRowNames[Index], ContextString);
+		}
+	}
+
+	ItemRarityRows.Init(nullptr, UE_ARRAY_COUNT(ShooterDataCache::ItemRarityRowNames));
+	if (ItemRarityDataTable)
+	{
+		for (int32 Index = 0; Index < ItemRarityRows.Num(); ++Index)
+		{
+			ItemRarityRows[Index] = ItemRarityDataTable->FindRow<FItemRarityTable>(ShooterDataCache::ItemRarityRowNames[Index], ContextString);
+		}
+	}
+}
+
+void UShooterDataCacheSubsystem::ReleaseTables()
+{
+#if WITH_EDITOR
+	if (WeaponDataTable)
+	{
+		WeaponDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+	if (ItemRarityDataTable)
+	{
+		ItemRarityDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+#endif
+
+	WeaponDataTable = nullptr;
+	ItemRarityDataTable = nullptr;
+	WeaponRows.Reset();
+	ItemRarityRows.Reset();
+	HitZoneTables.Reset();
+}
@@ -2,65 +2,195 @@
 
 #include "Explosive.h"
 
+#include "CollisionQueryParams.h"
+#include "Combat/ExplosionSchedulerSubsystem.h"
 #include "Components/SphereComponent.h"
+#include "Engine/World.h"
 #include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
+#include "Performance/EffectPoolSubsystem.h"
+#include "Performance/TelemetrySubsystem.h"
+#include "Shooter/Shooter.h"
 #include "Sound/SoundCue.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions"), STAT_Explosions, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosive Line Of Sight Traces"), STAT_ExplosiveLineOfSightTraces, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Explosive Damage"), STAT_ExplosiveDamage, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarExplosivePersistentOverlaps(
+	TEXT("Shooter.Explosive.PersistentOverlaps"),
+	0,
+	TEXT("When 1, explosives spawned afterwards keep their overlap sphere updated like before, to compare the idle cost. Damage always uses a query at detonation."));
+
 // Sets default values
 AExplosive::AExplosive() :
-	Damage(100.f)
+	Damage(100.f),
+	DamageInnerRadius(100.f),
+	MinimumDamage(20.f),
+	DamageFalloff(1.f),
+	OccludedDamageScale(0.f),
+	bPrimed(false)
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing to update per frame, everything happens in BulletHit
+	PrimaryActorTick.bCanEverTick = false;
 
 	ExplosiveMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Explosive Mesh"));
 	SetRootComponent(ExplosiveMeshComponent);
 
 	OverlapSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Overlap Sphere"));
 	OverlapSphere->SetupAttachment(GetRootComponent());
+	OverlapSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	OverlapSphere->SetGenerateOverlapEvents(false);
 }
 
 // Called when the game starts or when spawned
 void AExplosive::BeginPlay()
 {
 	Super::BeginPlay();
-	
-}
-
-// Called every frame
-void AExplosive::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
 
+	// Blueprints may have overridden the collision of the sphere, enforce it here
+	const bool bPersistentOverlaps = CVarExplosivePersistentOverlaps.GetValueOnGameThread() != 0;
+	OverlapSphere->SetCollisionEnabled(bPersistentOverlaps ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+	OverlapSphere->SetGenerateOverlapEvents(bPersistentOverlaps);
 }
 
 void AExplosive::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController)
 {
 	IBulletHitInterface::BulletHit_Implementation(HitResult, Shooter, ShooterController);
 
+	if (bPrimed)
+	{
+		return;
+	}
+
+	UExplosionSchedulerSubsystem* const ExplosionSchedulerSubsystem = GetWorld()->GetSubsystem<UExplosionSchedulerSubsystem>();
+	if (ExplosionSchedulerSubsystem)
+	{
+		ExplosionSchedulerSubsystem->QueueDetonation(this, Shooter, ShooterController, HitResult.Location);
+		return;
+	}
+
+	// No scheduler, explode on the spot without chaining
 	if (ExplodeSound)
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, ExplodeSound, GetActorLocation());
 	}
 
-	if (ExplodeParticles)
+	UEffectPoolSubsystem* const EffectPoolSubsystem = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if (ExplodeParticles && EffectPoolSubsystem)
+	{
+		EffectPoolSubsystem->SpawnEffectAtLocation(ExplodeParticles, HitResult.Location);
+	}
+
+	TSet<TWeakObjectPtr<AActor>> DamagedVictims;
+	TArray<AExplosive*> NearbyExplosives;
+	TArray<FExplosiveHit> Hits;
+	Explode(DamagedVictims, NearbyExplosives, Hits);
+
+	for (const FExplosiveHit& Hit : Hits)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplodeParticles, HitResult.Location, FRotator(0.f), true);
+		UGameplayStatics::ApplyDamage(Hit.Victim, Hit.Damage, ShooterController, Shooter, UDamageType::StaticClass());
 	}
+}
+
+void AExplosive::Explode(TSet<TWeakObjectPtr<AActor>>& DamagedVictims, TArray<AExplosive*>& OutNearbyExplosives, TArray<FExplosiveHit>& OutHits)
+{
+	INC_DWORD_STAT(STAT_Explosions);
+	UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_Explosion);
 
-	ApplyExplosiveDamage(Shooter, ShooterController);
+	bPrimed = true;
+
+	TArray<AActor*> Victims;
+	QueryBlastRadius(Victims, OutNearbyExplosives);
+	ComputeExplosiveDamage(Victims, DamagedVictims, OutHits);
 	Destroy();
 }
 
+void AExplosive::QueryBlastRadius(TArray<AActor*>& OutVictims, TArray<AExplosive*>& OutExplosives) const
+{
+	FCollisionObjectQueryParams ObjectParams(ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
 
-void AExplosive::ApplyExplosiveDamage(AActor* Shooter, AController* ShooterController) const
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ExplosiveOverlap), false, this);
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, OverlapSphere->GetComponentLocation(), FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(OverlapSphere->GetScaledSphereRadius()), QueryParams);
+
+	// An actor can overlap with several components
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* Actor = Overlap.GetActor();
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		if (Actor->IsA<ACharacter>())
+		{
+			OutVictims.AddUnique(Actor);
+		}
+		else if (AExplosive* Explosive = Cast<AExplosive>(Actor))
+		{
+			if (!Explosive->IsPrimed())
+			{
+				OutExplosives.AddUnique(Explosive);
+			}
+		}
+	}
+}
+
+void AExplosive::ComputeExplosiveDamage(const TArray<AActor*>& Victims, TSet<TWeakObjectPtr<AActor>>& DamagedVictims, TArray<FExplosiveHit>& OutHits) const
 {
-	TArray<AActor*> OverlappingActors;
-	GetOverlappingActors(OverlappingActors, ACharacter::StaticClass());
-	for (const auto Actor : OverlappingActors)
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ExplosiveDamage);
+
+	const FVector Origin = OverlapSphere->GetComponentLocation();
+	int32 LineOfSightTraces = 0;
+	for (AActor* Victim : Victims)
 	{
-		UGameplayStatics::ApplyDamage(Actor, Damage, ShooterController, Shooter, UDamageType::StaticClass());
+		if (DamagedVictims.Contains(Victim))
+		{
+			continue;
+		}
+
+		float VictimDamage = GetFalloffDamage(FVector::Dist(Origin, Victim->GetActorLocation()));
+		if (OccludedDamageScale < 1.f)
+		{
+			++LineOfSightTraces;
+			if (!HasLineOfSight(Origin, Victim))
+			{
+				VictimDamage *= OccludedDamageScale;
+			}
+		}
+
+		// Victims shielded from this barrel can still be hit by a later one of the chain
+		if (VictimDamage > 0.f)
+		{
+			DamagedVictims.Add(Victim);
+			OutHits.Add({ Victim, VictimDamage });
+		}
 	}
+
+	INC_DWORD_STAT_BY(STAT_ExplosiveLineOfSightTraces, LineOfSightTraces);
+	UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_TraceIssued, LineOfSightTraces);
+}
+
+float AExplosive::GetFalloffDamage(const float Distance) const
+{
+	const float OuterRadius = OverlapSphere->GetScaledSphereRadius();
+	if (Distance <= DamageInnerRadius || OuterRadius <= DamageInnerRadius)
+	{
+		return Damage;
+	}
+
+	const float Alpha = FMath::Clamp((Distance - DamageInnerRadius) / (OuterRadius - DamageInnerRadius), 0.f, 1.f);
+	return FMath::Lerp(Damage, MinimumDamage, FMath::Pow(Alpha, DamageFalloff));
+}
+
+bool AExplosive::HasLineOfSight(const FVector& Origin, const AActor* Victim) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ExplosiveLineOfSight), false, this);
+	QueryParams.AddIgnoredActor(Victim);
+	return !GetWorld()->LineTraceTestByChannel(Origin, Victim->GetActorLocation(), ECC_Visibility, QueryParams);
 }
 
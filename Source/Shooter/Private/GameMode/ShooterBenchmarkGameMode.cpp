@@ -0,0 +1,338 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/GameMode/ShooterBenchmarkGameMode.h"
+
+#include "Combat/HitscanSubsystem.h"
+#include "Combat/ProjectileSubsystem.h"
+#include "EngineUtils.h"
+#include "Explosive.h"
+#include "HAL/PlatformMemory.h"
+#include "Items/PickupPoolSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/AI/Enemy.h"
+#include "Shooter/Public/Items/Item.h"
+#include "Shooter/Public/Player/ShooterCharacter.h"
+
+namespace ShooterBenchmark
+{
+	/** Returns the value below which the given fraction of the values lie. */
+	static float Percentile(TArray<float> Values, const float Fraction)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.f;
+		}
+
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	}
+
+	/** Returns the location of the grid cell, rows going away from the origin along Forward. */
+	static FVector GridLocation(const FVector& Origin, const FVector& Forward, const FVector& Right, const int32 Index, const int32 Columns, const float Spacing)
+	{
+		const int32 Row = Index / Columns;
+		const int32 Column = Index % Columns - Columns / 2;
+		return Origin + Forward * (Row * Spacing) + Right * (Column * Spacing);
+	}
+}
+
+AShooterBenchmarkGameMode::AShooterBenchmarkGameMode() :
+	SpawnDistance(1500.f),
+	SpawnSpacing(300.f),
+	NumEnemies(20),
+	NumItems(50),
+	NumExplosives(10),
+	NumWarmupFrames(120),
+	NumFrames(600),
+	BenchmarkName(TEXT("ShooterBenchmark")),
+	FrameCount(0),
+	FrameStartSeconds(0.0),
+	LastFrameStartSeconds(0.0),
+	LastBulletsSent(0),
+	LastSendBulletSeconds(0.0),
+	LastShotResolveSeconds(0.0),
+	LastItemTicks(0),
+	bHoldFire(true),
+	bFinished(false)
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void AShooterBenchmarkGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	// The player is spawned after InitGame, so the classes have to be set before
+	if (UClass* PawnClass = BenchmarkPawnClass.LoadSynchronous())
+	{
+		DefaultPawnClass = PawnClass;
+	}
+	if (UClass* ControllerClass = BenchmarkPlayerControllerClass.LoadSynchronous())
+	{
+		PlayerControllerClass = ControllerClass;
+	}
+
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	ParseCommandLine();
+}
+
+void AShooterBenchmarkGameMode::ParseCommandLine()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("BenchEnemies="), NumEnemies);
+	FParse::Value(CommandLine, TEXT("BenchItems="), NumItems);
+	FParse::Value(CommandLine, TEXT("BenchExplosives="), NumExplosives);
+	FParse::Value(CommandLine, TEXT("BenchWarmupFrames="), NumWarmupFrames);
+	FParse::Value(CommandLine, TEXT("BenchFrames="), NumFrames);
+	FParse::Value(CommandLine, TEXT("BenchName="), BenchmarkName);
+	bHoldFire = !FParse::Param(CommandLine, TEXT("BenchIdle"));
+
+	NumFrames = FMath::Max(1, NumFrames);
+}
+
+void AShooterBenchmarkGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BenchmarkCharacter = Cast<AShooterCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+	if (!BenchmarkCharacter.IsValid())
+	{
+		UE_LOG(LogShooter, Error, TEXT("Benchmark needs an AShooterCharacter player; check BenchmarkPawnClass."));
+		return;
+	}
+
+	SpawnBenchmarkActors();
+
+	Frames.Reserve(NumFrames);
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddUObject(this, &AShooterBenchmarkGameMode::OnBeginFrame);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &AShooterBenchmarkGameMode::OnEndFrame);
+
+	UE_LOG(LogShooter, Log, TEXT("Benchmark %s: %d enemies, %d items, %d explosives, %d warmup frames, %d frames"),
+		*BenchmarkName, NumEnemies, NumItems, NumExplosives, NumWarmupFrames, NumFrames);
+}
+
+void AShooterBenchmarkGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterBenchmarkGameMode::SpawnBenchmarkActors()
+{
+	UWorld* World = GetWorld();
+	const FVector Forward = BenchmarkCharacter->GetActorForwardVector().GetSafeNormal2D();
+	const FVector Right = FVector::CrossProduct(FVector::UpVector, Forward);
+	const FVector Origin = BenchmarkCharacter->GetActorLocation() + Forward * SpawnDistance;
+	const FRotator FacingPlayer = (-Forward).Rotation();
+	constexpr int32 Columns = 10;
+
+	UClass* EnemyActorClass = EnemyClass.LoadSynchronous();
+	for (int32 Index = 0; EnemyActorClass && Index < NumEnemies; ++Index)
+	{
+		const FTransform SpawnTransform(FacingPlayer, ShooterBenchmark::GridLocation(Origin, Forward, Right, Index, Columns, SpawnSpacing));
+		AEnemy* Enemy = World->SpawnActorDeferred<AEnemy>(EnemyActorClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (Enemy)
+		{
+			// Spawned pawns only get their AI controller when asked to
+			Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+			UGameplayStatics::FinishSpawningActor(Enemy, SpawnTransform);
+		}
+	}
+
+	// Explosives stand between the player and the enemies so shots hit both
+	UClass* ExplosiveActorClass = ExplosiveClass.LoadSynchronous();
+	const FVector ExplosiveOrigin = Origin - Forward * SpawnSpacing;
+	for (int32 Index = 0; ExplosiveActorClass && Index < NumExplosives; ++Index)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		const FVector Location = ShooterBenchmark::GridLocation(ExplosiveOrigin, -Forward, Right, Index, Columns, SpawnSpacing * 0.5f);
+		World->SpawnActor<AExplosive>(ExplosiveActorClass, Location, FRotator::ZeroRotator, SpawnParameters);
+	}
+
+	// Pickups are scattered around the player, where they trace and pulse
+	UClass* ItemActorClass = ItemClass.LoadSynchronous();
+	UPickupPoolSubsystem* const PickupPoolSubsystem = World->GetSubsystem<UPickupPoolSubsystem>();
+	for (int32 Index = 0; ItemActorClass && PickupPoolSubsystem && Index < NumItems; ++Index)
+	{
+		const FVector2D Offset = FMath::RandPointInCircle(SpawnDistance);
+		const FTransform SpawnTransform(BenchmarkCharacter->GetActorLocation() + FVector(Offset, 0.f));
+		PickupPoolSubsystem->AcquireItem(ItemActorClass, SpawnTransform);
+	}
+}
+
+void AShooterBenchmarkGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Press fire every recorded frame; FireWeapon ignores presses while the weapon is busy
+	if (bHoldFire && !bFinished && FrameCount >= NumWarmupFrames && BenchmarkCharacter.IsValid())
+	{
+		BenchmarkCharacter->SetFireButtonPressed(true);
+	}
+}
+
+void AShooterBenchmarkGameMode::OnBeginFrame()
+{
+	LastFrameStartSeconds = FrameStartSeconds;
+	FrameStartSeconds = FPlatformTime::Seconds();
+}
+
+void AShooterBenchmarkGameMode::OnEndFrame()
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	const double GameThreadSeconds = FPlatformTime::Seconds() - FrameStartSeconds;
+	const AShooterCharacter* Character = BenchmarkCharacter.Get();
+	const int32 BulletsSent = Character ? Character->GetBulletsSent() : LastBulletsSent;
+	const double SendBulletSeconds = Character ? Character->GetSendBulletSeconds() : LastSendBulletSeconds;
+
+	// SendBullet only queues shots; the traces and damage run when the subsystems tick
+	double ShotResolveSeconds = 0.0;
+	if (const UHitscanSubsystem* HitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>())
+	{
+		ShotResolveSeconds += HitscanSubsystem->GetTickSeconds();
+	}
+	if (const UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>())
+	{
+		ShotResolveSeconds += ProjectileSubsystem->GetTickSeconds();
+	}
+
+	const uint64 ItemTicks = AItem::GetTotalTicks();
+
+	// The first frame has no previous frame start
+	if (FrameCount++ >= NumWarmupFrames && LastFrameStartSeconds > 0.0)
+	{
+		FShooterBenchmarkFrame& Frame = Frames.AddDefaulted_GetRef();
+		Frame.FrameMilliseconds = (FrameStartSeconds - LastFrameStartSeconds) * 1000.0;
+		Frame.GameThreadMilliseconds = GameThreadSeconds * 1000.0;
+		Frame.SendBulletMilliseconds = (SendBulletSeconds - LastSendBulletSeconds) * 1000.0;
+		Frame.ShotResolveMilliseconds = (ShotResolveSeconds - LastShotResolveSeconds) * 1000.0;
+		Frame.BulletsSent = BulletsSent - LastBulletsSent;
+		Frame.TickEnabledActors = CountTickEnabledActors();
+		Frame.ItemTicks = static_cast<int32>(ItemTicks - LastItemTicks);
+		Frame.UsedPhysicalBytes = FPlatformMemory::GetStats().UsedPhysical;
+	}
+
+	LastBulletsSent = BulletsSent;
+	LastSendBulletSeconds = SendBulletSeconds;
+	LastShotResolveSeconds = ShotResolveSeconds;
+	LastItemTicks = ItemTicks;
+
+	if (Frames.Num() < NumFrames)
+	{
+		return;
+	}
+
+	bFinished = true;
+	if (Character)
+	{
+		BenchmarkCharacter->SetFireButtonPressed(false);
+	}
+	WriteResults();
+
+	if (FApp::IsUnattended() || FParse::Param(FCommandLine::Get(), TEXT("BenchExit")))
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+int32 AShooterBenchmarkGameMode::CountTickEnabledActors() const
+{
+	int32 TickEnabledActors = 0;
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (It->IsActorTickEnabled())
+		{
+			++TickEnabledActors;
+		}
+	}
+	return TickEnabledActors;
+}
+
+void AShooterBenchmarkGameMode::WriteResults() const
+{
+	FString FramesCsv(TEXT("Frame,FrameMs,GameThreadMs,SendBulletMs,ShotResolveMs,BulletsSent,TickEnabledActors,ItemTicks,UsedPhysicalMB\n"));
+
+	TArray<float> FrameMilliseconds;
+	TArray<float> GameThreadMilliseconds;
+	double TotalFrameMilliseconds = 0.0;
+	double TotalGameThreadMilliseconds = 0.0;
+	double TotalSendBulletMilliseconds = 0.0;
+	double TotalShotResolveMilliseconds = 0.0;
+	int32 TotalBulletsSent = 0;
+	int64 TotalTickEnabledActors = 0;
+	int64 TotalItemTicks = 0;
+
+	for (int32 Index = 0; Index < Frames.Num(); ++Index)
+	{
+		const FShooterBenchmarkFrame& Frame = Frames[Index];
+		FramesCsv += FString::Printf(TEXT("%d,%.3f,%.3f,%.4f,%.4f,%d,%d,%d,%.1f\n"),
+			Index,
+			Frame.FrameMilliseconds,
+			Frame.GameThreadMilliseconds,
+			Frame.SendBulletMilliseconds,
+			Frame.ShotResolveMilliseconds,
+			Frame.BulletsSent,
+			Frame.TickEnabledActors,
+			Frame.ItemTicks,
+			Frame.UsedPhysicalBytes / (1024.0 * 1024.0));
+
+		FrameMilliseconds.Add(Frame.FrameMilliseconds);
+		GameThreadMilliseconds.Add(Frame.GameThreadMilliseconds);
+		TotalFrameMilliseconds += Frame.FrameMilliseconds;
+		TotalGameThreadMilliseconds += Frame.GameThreadMilliseconds;
+		TotalSendBulletMilliseconds += Frame.SendBulletMilliseconds;
+		TotalShotResolveMilliseconds += Frame.ShotResolveMilliseconds;
+		TotalBulletsSent += Frame.BulletsSent;
+		TotalTickEnabledActors += Frame.TickEnabledActors;
+		TotalItemTicks += Frame.ItemTicks;
+	}
+
+	const int32 NumRecorded = FMath::Max(1, Frames.Num());
+	const double AverageFrameMilliseconds = TotalFrameMilliseconds / NumRecorded;
+	const double AverageGameThreadMilliseconds = TotalGameThreadMilliseconds / NumRecorded;
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	const FString SummaryCsv = FString::Printf(
+		TEXT("Enemies,Items,Explosives,Frames,AvgFrameMs,P95FrameMs,AvgGameThreadMs,P95GameThreadMs,AvgSendBulletUs,AvgShotUs,BulletsSent,AvgTickEnabledActors,AvgItemTicks,PeakUsedPhysicalMB\n")
+		TEXT("%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%d,%.1f,%.1f,%.1f\n"),
+		NumEnemies,
+		NumItems,
+		NumExplosives,
+		Frames.Num(),
+		AverageFrameMilliseconds,
+		ShooterBenchmark::Percentile(FrameMilliseconds, 0.95f),
+		AverageGameThreadMilliseconds,
+		ShooterBenchmark::Percentile(GameThreadMilliseconds, 0.95f),
+		TotalBulletsSent > 0 ? TotalSendBulletMilliseconds * 1000.0 / TotalBulletsSent : 0.0,
+		TotalBulletsSent > 0 ? (TotalSendBulletMilliseconds + TotalShotResolveMilliseconds) * 1000.0 / TotalBulletsSent : 0.0,
+		TotalBulletsSent,
+		static_cast<double>(TotalTickEnabledActors) / NumRecorded,
+		static_cast<double>(TotalItemTicks) / NumRecorded,
+		MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+
+	const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"));
+	const FString Stamp = FDateTime::Now().ToString();
+	const FString FramesPath = FPaths::Combine(Directory, FString::Printf(TEXT("%s-%s-Frames.csv"), *BenchmarkName, *Stamp));
+	const FString SummaryPath = FPaths::Combine(Directory, FString::Printf(TEXT("%s-%s-Summary.csv"), *BenchmarkName, *Stamp));
+
+	if (!FFileHelper::SaveStringToFile(FramesCsv, *FramesPath) || !FFileHelper::SaveStringToFile(SummaryCsv, *SummaryPath))
+	{
+		UE_LOG(LogShooter, Error, TEXT("Could not write the benchmark results to %s."), *Directory);
+		return;
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("Benchmark %s done: %.3f ms average frame, %.3f ms average game thread. Results in %s"),
+		*BenchmarkName, AverageFrameMilliseconds, AverageGameThreadMilliseconds, *SummaryPath);
+}
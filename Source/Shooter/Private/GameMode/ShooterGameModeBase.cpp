@@ -3,3 +3,21 @@
 
 #include "Shooter/Public/GameMode/ShooterGameModeBase.h"
 
+#include "Items/PickupPoolSubsystem.h"
+#include "UI/ShooterHUD.h"
+
+AShooterGameModeBase::AShooterGameModeBase()
+{
+	HUDClass = AShooterHUD::StaticClass();
+}
+
+void AShooterGameModeBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UPickupPoolSubsystem* const PickupPoolSubsystem = GetWorld()->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPoolSubsystem)
+	{
+		PickupPoolSubsystem->PrewarmConfiguredPools();
+	}
+}
@@ -45,6 +45,13 @@ void AAmmo::AmmoSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 	}
 }
 
+void AAmmo::OnAcquiredFromPool()
+{
+	Super::OnAcquiredFromPool();
+
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+}
+
 void AAmmo::SetItemProperties(EItemState State)
 {
 	Super::SetItemProperties(State);
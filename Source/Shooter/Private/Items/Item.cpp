@@ -9,9 +9,21 @@
 #include "Shooter/Public/Player/ShooterCharacter.h"
 #include "Camera/CameraComponent.h"
 #include "Curves/CurveVector.h"
+#include "Data/ShooterDataCacheSubsystem.h"
+#include "Engine/Texture2D.h"
+#include "Items/ItemPulseSubsystem.h"
 #include "Kismet/GameplayStatics.h"
+#include "Performance/TelemetrySubsystem.h"
+#include "Performance/TickThrottleSubsystem.h"
+#include "Shooter/Shooter.h"
 #include "Sound/SoundCue.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Items Interpolating"), STAT_ItemsInterpolating, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Item Interpolation"), STAT_ItemInterpolation, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Item Pulse"), STAT_ItemPulse, STATGROUP_Shooter);
+
+uint64 AItem::TotalTicks = 0;
+
 // Sets default values
 AItem::AItem() :
 	ItemName(FString("Default")),
@@ -35,6 +47,8 @@ AItem::AItem() :
 	GlowAmount(150.f),
 	FresnelExponent(3.f),
 	FresnelReflectFraction(4.f),
+	bUseMaterialPulse(true),
+	bMaterialSupportsPulse(false),
 	SlotIndex(0),
 	bCharacterInventoryFull(false)
 {
@@ -75,6 +89,12 @@ void AItem::BeginPlay()
 	InitializeCustomDepth();
 
 	StartPulseTimer();
+	UpdateTickEnabled();
+
+	if (UTickThrottleSubsystem* TickThrottleSubsystem = GetWorld()->GetSubsystem<UTickThrottleSubsystem>())
+	{
+		TickThrottleSubsystem->RegisterActor(this);
+	}
 }
 
 void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult & SweepResult)
@@ -243,10 +263,67 @@ void AItem::StartPulseTimer()
 {
 	if (ItemState == EItemState::EIS_Pickup)
 	{
+		if (UsesMaterialPulse())
+		{
+			// The material evaluates the pulse; no timer or tick needed
+			StartMaterialPulse();
+			return;
+		}
+		
 		GetWorldTimerManager().SetTimer(PulseTimer, this, &AItem::ResetPulseTimer, PulseCurveTime);
 	}
 }
 
+void AItem::StartMaterialPulse() const
+{
+	if (DynamicMaterialInstance == nullptr)
+	{
+		return;
+	}
+
+	UItemPulseSubsystem* const PulseSubsystem = GetWorld()->GetSubsystem<UItemPulseSubsystem>();
+	UTexture2D* const PulseTexture = PulseSubsystem ? PulseSubsystem->GetPulseCurveTexture(PulseCurve, PulseCurveTime) : nullptr;
+	if (PulseTexture == nullptr)
+	{
+		// Nothing to bake; push the CPU values once
+		SetMaterialPulseEnabled(false);
+		UpdatePulse();
+		return;
+	}
+
+	DynamicMaterialInstance->SetTextureParameterValue(TEXT("Pulse Curve"), PulseTexture);
+	DynamicMaterialInstance->SetScalarParameterValue(TEXT("Pulse Start Time"), GetWorld()->GetTimeSeconds());
+	DynamicMaterialInstance->SetScalarParameterValue(TEXT("Pulse Duration"), PulseCurveTime);
+	DynamicMaterialInstance->SetScalarParameterValue(TEXT("Pulse Glow Amount"), GlowAmount);
+	DynamicMaterialInstance->SetScalarParameterValue(TEXT("Pulse Fresnel Exponent"), FresnelExponent);
+	DynamicMaterialInstance->SetScalarParameterValue(TEXT("Pulse Fresnel Reflect Fraction"), FresnelReflectFraction);
+	SetMaterialPulseEnabled(true);
+}
+
+void AItem::SetMaterialPulseEnabled(const bool bEnable) const
+{
+	if (DynamicMaterialInstance)
+	{
+		DynamicMaterialInstance->SetScalarParameterValue(TEXT("Material Pulse"), bEnable ? 1.f : 0.f);
+	}
+}
+
+bool AItem::ShouldTickInState(const EItemState State) const
+{
+	// Without the material pulse UpdatePulse has to run every frame
+	return !UsesMaterialPulse() || State == EItemState::EIS_EquipInterping;
+}
+
+void AItem::UpdateTickEnabled()
+{
+	SetActorTickEnabled(ShouldTickInState(ItemState));
+
+	if (UTickThrottleSubsystem* TickThrottleSubsystem = GetWorld()->GetSubsystem<UTickThrottleSubsystem>())
+	{
+		TickThrottleSubsystem->OnActorTickChanged(this);
+	}
+}
+
 void AItem::ResetPulseTimer()
 {
 	StartPulseTimer();
@@ -264,33 +341,11 @@ void AItem::OnConstruction(const FTransform& MovieSceneBlends)
 {
 	Super::OnConstruction(MovieSceneBlends);
 	
-	// Load the data in the Item Rarity Table
-	// Path to the Item Rarity Data Table
-	const FString RarityTablePath(TEXT("DataTable'/Game/DataTable/ItemRarity_DataTable.ItemRarity_DataTable'"));
-	const UDataTable* RarityTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *RarityTablePath));
-	if (RarityTableObject)
+	// Rarity rows are loaded once and cached by the game instance
+	const UShooterDataCacheSubsystem* DataCache = UShooterDataCacheSubsystem::Get(this);
+	if (DataCache)
 	{
-		FItemRarityTable* RarityRow = nullptr;
-		switch(ItemRarity)
-		{
-		case EItemRarity::EIR_Damaged:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-		break;
-		case EItemRarity::EIR_Common:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-		break;
-		case EItemRarity::EIR_Uncommon:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-		break;
-		case EItemRarity::EIR_Rare:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-		break;
-		case EItemRarity::EIR_Legendary:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
-		break;
-		default:;
-		}
-
+		const FItemRarityTable* RarityRow = DataCache->GetItemRarityData(ItemRarity);
 		if (RarityRow)
 		{
 			GlowColor = RarityRow->GlowColor;
@@ -311,6 +366,10 @@ void AItem::OnConstruction(const FTransform& MovieSceneBlends)
 		DynamicMaterialInstance->SetVectorParameterValue(TEXT("Fresnel Color"), GlowColor);
 		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
 
+		// Materials that do not read the pulse parameters keep the CPU driven pulse
+		float MaterialPulse;
+		bMaterialSupportsPulse = DynamicMaterialInstance->GetScalarParameterValue(FMaterialParameterInfo(TEXT("Material Pulse")), MaterialPulse);
+
 		GlowMaterialEnabled(true);
 	}
 }
@@ -328,6 +387,44 @@ void AItem::SetItemState(const EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(State);
+
+	if (UsesMaterialPulse() && State != EItemState::EIS_Pickup)
+	{
+		// Outside of the Pickup state the material parameters are driven from the CPU again
+		SetMaterialPulseEnabled(false);
+		UpdatePulse();
+	}
+	
+	UpdateTickEnabled();
+}
+
+void AItem::OnAcquiredFromPool()
+{
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	SetItemState(EItemState::EIS_Pickup);
+	StartPulseTimer();
+}
+
+void AItem::OnReleasedToPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	bInterpolating = false;
+
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	ItemMesh->SetSimulatePhysics(false);
+	PickUpWidget->SetVisibility(false);
+	CustomDepthEnabled(false);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	if (UTickThrottleSubsystem* TickThrottleSubsystem = GetWorld()->GetSubsystem<UTickThrottleSubsystem>())
+	{
+		TickThrottleSubsystem->OnActorTickChanged(this);
+	}
 }
 
 void AItem::StartItemCurve(AShooterCharacter* Character, bool bForcePlaySound)
@@ -397,6 +494,8 @@ void AItem::FinishInterpolating()
 void AItem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	++TotalTicks;
+	UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_ItemTick);
 
 	// Handle Item Interpolating when in the EquipInterping state
 	ItemInterpolation(DeltaTime);
@@ -412,6 +511,9 @@ void AItem::ItemInterpolation(const float DeltaTime)
 		return;
 	}
 
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemInterpolation);
+	INC_DWORD_STAT(STAT_ItemsInterpolating);
+
 	if (ShooterCharacterRef && ItemZCurve)
 	{
 		// Elapsed time since we started ItemInterpolationTimer
@@ -479,6 +581,8 @@ FVector AItem::GetInterpolationLocation() const
 
 void AItem::UpdatePulse() const
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemPulse);
+
 	float ElapsedTime;
 	FVector CurveValue { };
 	
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Items/ItemPulseSubsystem.h"
+
+#include "Curves/CurveVector.h"
+#include "Engine/Texture2D.h"
+#include "Shooter/Shooter.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Item Pulse Textures"), STAT_ItemPulseTextures, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Item Pulse Texture Bake"), STAT_ItemPulseTextureBake, STATGROUP_Shooter);
+
+void UItemPulseSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ItemPulseTextures, PulseTextures.Num());
+	PulseTextureLookup.Empty();
+	PulseTextures.Empty();
+
+	Super::Deinitialize();
+}
+
+UTexture2D* UItemPulseSubsystem::GetPulseCurveTexture(UCurveVector* PulseCurve, const float PulseCurveTime)
+{
+	if (PulseCurve == nullptr || PulseCurveTime <= 0.f)
+	{
+		return nullptr;
+	}
+
+	const TPair<const UCurveVector*, float> Key(PulseCurve, PulseCurveTime);
+	UTexture2D** const CachedTexture = PulseTextureLookup.Find(Key);
+	if (CachedTexture)
+	{
+		return *CachedTexture;
+	}
+
+	UTexture2D* const PulseTexture = BakePulseCurveTexture(PulseCurve, PulseCurveTime);
+	if (PulseTexture)
+	{
+		PulseTextures.Add(PulseTexture);
+		INC_DWORD_STAT(STAT_ItemPulseTextures);
+		PulseTextureLookup.Add(Key, PulseTexture);
+	}
+
+	return PulseTexture;
+}
+
+UTexture2D* UItemPulseSubsystem::BakePulseCurveTexture(const UCurveVector* PulseCurve, const float PulseCurveTime)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemPulseTextureBake);
+
+	UTexture2D* const PulseTexture = UTexture2D::CreateTransient(PulseTextureWidth, 1, PF_A32B32G32R32F);
+	if (PulseTexture == nullptr || PulseTexture->PlatformData == nullptr || PulseTexture->PlatformData->Mips.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	PulseTexture->SRGB = false;
+	PulseTexture->Filter = TextureFilter::TF_Bilinear;
+	PulseTexture->AddressX = TextureAddress::TA_Wrap;
+	PulseTexture->AddressY = TextureAddress::TA_Clamp;
+
+	// One texel per sample; X, Y and Z of the curve go into R, G and B
+	FTexture2DMipMap& Mip = PulseTexture->PlatformData->Mips[0];
+	FLinearColor* const Texels = static_cast<FLinearColor*>(Mip.BulkData.Lock(LOCK_READ_WRITE));
+	for (int32 i = 0; i < PulseTextureWidth; ++i)
+	{
+		const float SampleTime = PulseCurveTime * i / PulseTextureWidth;
+		const FVector CurveValue = PulseCurve->GetVectorValue(SampleTime);
+		Texels[i] = FLinearColor(CurveValue.X, CurveValue.Y, CurveValue.Z, 1.f);
+	}
+	Mip.BulkData.Unlock();
+
+	PulseTexture->UpdateResource();
+	return PulseTexture;
+}
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Items/PickupPoolSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/Items/Item.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Pool Hits"), STAT_PickupPoolHits, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Pool Misses"), STAT_PickupPoolMisses, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickup Pool Parked Items"), STAT_PickupPoolParked, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Pickup Pool Spawn"), STAT_PickupPoolSpawn, STATGROUP_Shooter);
+
+static FAutoConsoleCommandWithWorld PickupPoolDumpCommand(
+	TEXT("Shooter.PickupPool.Dump"),
+	TEXT("Log the hits, misses and spawn time avoided of every pickup pool."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UPickupPoolSubsystem* PickupPoolSubsystem = World ? World->GetSubsystem<UPickupPoolSubsystem>() : nullptr;
+		if (PickupPoolSubsystem)
+		{
+			PickupPoolSubsystem->DumpStats();
+		}
+	}));
+
+void UPickupPoolSubsystem::Deinitialize()
+{
+	// Parked actors belong to the level and are destroyed with it
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPickupPoolSubsystem::PrewarmConfiguredPools()
+{
+	for (const FPickupPoolPrewarm& PrewarmPool : PrewarmPools)
+	{
+		UClass* ItemClass = PrewarmPool.ItemClass.LoadSynchronous();
+		if (ItemClass == nullptr)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Pickup pool class %s could not be loaded."), *PrewarmPool.ItemClass.ToString());
+			continue;
+		}
+		Prewarm(ItemClass, PrewarmPool.Count);
+	}
+}
+
+void UPickupPoolSubsystem::Prewarm(const TSubclassOf<AItem> ItemClass, const int32 Count)
+{
+	if (ItemClass == nullptr)
+	{
+		return;
+	}
+
+	FPickupPool& Pool = Pools.FindOrAdd(ItemClass);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		AItem* Item = SpawnItem(ItemClass, FTransform::Identity, Pool);
+		if (Item)
+		{
+			Item->OnReleasedToPool();
+			Pool.FreeItems.Add(Item);
+			INC_DWORD_STAT(STAT_PickupPoolParked);
+		}
+	}
+}
+
+AItem* UPickupPoolSubsystem::AcquireItem(const TSubclassOf<AItem> ItemClass, const FTransform& Transform)
+{
+	if (ItemClass == nullptr || GetWorld() == nullptr)
+	{
+		return nullptr;
+	}
+
+	FPickupPool& Pool = Pools.FindOrAdd(ItemClass);
+
+	AItem* Item = nullptr;
+	while (Item == nullptr && Pool.FreeItems.Num() > 0)
+	{
+		Item = Pool.FreeItems.Pop(false);
+		DEC_DWORD_STAT(STAT_PickupPoolParked);
+		if (Item && Item->IsPendingKill())
+		{
+			Item = nullptr;
+		}
+	}
+
+	if (Item == nullptr)
+	{
+		++Pool.Misses;
+		INC_DWORD_STAT(STAT_PickupPoolMisses);
+		return SpawnItem(ItemClass, Transform, Pool);
+	}
+
+	++Pool.Hits;
+	Pool.SecondsAvoided += Pool.SpawnCount > 0 ? Pool.SpawnSeconds / Pool.SpawnCount : 0.0;
+	INC_DWORD_STAT(STAT_PickupPoolHits);
+
+	Item->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Item->OnAcquiredFromPool();
+	return Item;
+}
+
+void UPickupPoolSubsystem::ReleaseItem(AItem* Item)
+{
+	if (Item == nullptr || Item->IsPendingKill())
+	{
+		return;
+	}
+
+	Item->OnReleasedToPool();
+	Pools.FindOrAdd(Item->GetClass()).FreeItems.Add(Item);
+	INC_DWORD_STAT(STAT_PickupPoolParked);
+}
+
+AItem* UPickupPoolSubsystem::SpawnItem(UClass* ItemClass, const FTransform& Transform, FPickupPool& Pool) const
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_PickupPoolSpawn);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	AItem* Item = GetWorld()->SpawnActor<AItem>(ItemClass, Transform, SpawnParameters);
+	Pool.SpawnSeconds += FPlatformTime::Seconds() - StartSeconds;
+	++Pool.SpawnCount;
+
+	return Item;
+}
+
+void UPickupPoolSubsystem::DumpStats() const
+{
+	double TotalSecondsAvoided = 0.0;
+	UE_LOG(LogShooter, Log, TEXT("Pickup pools:"));
+
+	for (const auto& PoolPair : Pools)
+	{
+		const FPickupPool& Pool = PoolPair.Value;
+		const double AverageSpawnMilliseconds = Pool.SpawnCount > 0 ? Pool.SpawnSeconds * 1000.0 / Pool.SpawnCount : 0.0;
+		TotalSecondsAvoided += Pool.SecondsAvoided;
+
+		UE_LOG(LogShooter, Log, TEXT("  %s: %d hits, %d misses, %d parked, %.3f ms average spawn, %.2f ms of spawning avoided"),
+			*GetNameSafe(PoolPair.Key),
+			Pool.Hits,
+			Pool.Misses,
+			Pool.FreeItems.Num(),
+			AverageSpawnMilliseconds,
+			Pool.SecondsAvoided * 1000.0);
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("  Spawn time avoided: %.2f ms in total"), TotalSecondsAvoided * 1000.0);
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Items/Shotgun.h"
+
+#include "Data/ShooterDataCacheSubsystem.h"
+#include "FWeaponDataTable.h"
+
+AShotgun::AShotgun() :
+	PelletCount(8),
+	PelletSpreadAngle(6.f),
+	SpreadSeed(0)
+{
+	SetWeaponType(EWeaponType::EWT_Shotgun);
+}
+
+void AShotgun::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	const UShooterDataCacheSubsystem* DataCache = UShooterDataCacheSubsystem::Get(this);
+	const FWeaponDataTable* WeaponDataRow = DataCache ? DataCache->GetWeaponData(GetWeaponType()) : nullptr;
+	if (WeaponDataRow)
+	{
+		PelletCount = WeaponDataRow->PelletCount;
+		PelletSpreadAngle = WeaponDataRow->PelletSpreadAngle;
+	}
+}
+
+void AShotgun::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (SpreadSeed != 0)
+	{
+		SpreadStream.Initialize(SpreadSeed);
+	}
+	else
+	{
+		SpreadStream.GenerateNewSeed();
+	}
+}
+
+void AShotgun::GeneratePelletDirections(const FVector& AimDirection, TArrayView<FVector> OutDirections)
+{
+	// Pellets land uniformly on the disk at unit distance that the cone cuts out
+	const float ConeRadius = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(PelletSpreadAngle, 0.f, 45.f)));
+	FVector Right;
+	FVector Up;
+	AimDirection.FindBestAxisVectors(Right, Up);
+
+	for (FVector& Direction : OutDirections)
+	{
+		const float Radius = FMath::Sqrt(SpreadStream.GetFraction()) * ConeRadius;
+		float Sin;
+		float Cos;
+		FMath::SinCos(&Sin, &Cos, SpreadStream.GetFraction() * 2.f * PI);
+		Direction = (AimDirection + Right * (Cos * Radius) + Up * (Sin * Radius)).GetUnsafeNormal();
+	}
+}
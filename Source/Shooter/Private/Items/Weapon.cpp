@@ -2,6 +2,7 @@
 
 #include "Shooter/Public/Items/Weapon.h"
 #include "FWeaponDataTable.h"
+#include "Data/ShooterDataCacheSubsystem.h"
 
 AWeapon::AWeapon() :
 	ThrowWeaponTime(0.7f),
@@ -17,7 +18,10 @@ AWeapon::AWeapon() :
 	MaxSlideDisplacement(4.f),
 	MaxRecoilRotation(20.f),
 	bMovingSlide(false),
-	bAutomatic(true)
+	bAutomatic(true),
+	FireMode(EFireMode::EFM_Hitscan),
+	MuzzleVelocity(30000.f),
+	ProjectileGravityScale(1.f)
 {
 	PrimaryActorTick.bCanEverTick = true;	
 }
@@ -36,6 +40,11 @@ void AWeapon::Tick(float DeltaSeconds)
 	UpdateSlideDisplacement();
 }
 
+bool AWeapon::ShouldTickInState(const EItemState State) const
+{
+	return Super::ShouldTickInState(State) || State == EItemState::EIS_Falling || State == EItemState::EIS_Equipped;
+}
+
 void AWeapon::UpdateSlideDisplacement()
 {
 	if(SlideDisplacementCurve == nullptr && bMovingSlide)
@@ -64,26 +73,10 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
-	const FString WeaponTablePath(TEXT("DataTable'/Game/DataTable/Weapon_DataTable.Weapon_DataTable'"));
-	const UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
-
-	if (WeaponTableObject)
+	const UShooterDataCacheSubsystem* DataCache = UShooterDataCacheSubsystem::Get(this);
+	if (DataCache)
 	{
-		FWeaponDataTable* WeaponDataRow = nullptr;
-		switch (WeaponType)
-		{
-		case EWeaponType::EWT_SubmachineGun:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("SubmachineGun"), TEXT(""));
-		break;
-		case EWeaponType::EWT_AssaultRifle:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("AssaultRifle"), TEXT(""));
-		break;
-		case EWeaponType::EWT_Pistol:
-            WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("Pistol"), TEXT(""));
-		break;
-		default: break;
-		}
-
+		const FWeaponDataTable* WeaponDataRow = DataCache->GetWeaponData(WeaponType);
 		if (WeaponDataRow)
 		{
 			AmmoType = WeaponDataRow->AmmoType;
@@ -123,6 +116,18 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 
 			Damage = WeaponDataRow->Damage;
 			HeadShotDamage = WeaponDataRow->HeadShotDamage;
+
+			FireMode = WeaponDataRow->FireMode;
+			MuzzleVelocity = WeaponDataRow->MuzzleVelocity;
+			ProjectileGravityScale = WeaponDataRow->ProjectileGravityScale;
+
+			ZoneDamage.SetNum(static_cast<int32>(EHitZone::EHZ_MAX));
+			for (int32 ZoneIndex = 0; ZoneIndex < ZoneDamage.Num(); ++ZoneIndex)
+			{
+				const EHitZone HitZone = static_cast<EHitZone>(ZoneIndex);
+				const float* Multiplier = WeaponDataRow->ZoneDamageMultipliers.Find(HitZone);
+				ZoneDamage[ZoneIndex] = Multiplier ? Damage * *Multiplier : (HitZone == EHitZone::EHZ_Head ? HeadShotDamage : Damage);
+			}
 		}
 
 		if (GetMaterialInstance())
@@ -136,6 +141,32 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 	}
 }
 
+float AWeapon::GetZoneDamage(const EHitZone HitZone) const
+{
+	const int32 ZoneIndex = static_cast<int32>(HitZone);
+	if (ZoneDamage.IsValidIndex(ZoneIndex))
+	{
+		return ZoneDamage[ZoneIndex];
+	}
+	return HitZone == EHitZone::EHZ_Head ? HeadShotDamage : Damage;
+}
+
+void AWeapon::OnAcquiredFromPool()
+{
+	Super::OnAcquiredFromPool();
+
+	bFalling = false;
+	bMovingSlide = false;
+	SlideDisplacement = 0.f;
+
+	const UShooterDataCacheSubsystem* DataCache = UShooterDataCacheSubsystem::Get(this);
+	const FWeaponDataTable* WeaponDataRow = DataCache ? DataCache->GetWeaponData(WeaponType) : nullptr;
+	if (WeaponDataRow)
+	{
+		Ammo = WeaponDataRow->WeaponAmmo;
+	}
+}
+
 void AWeapon::BeginPlay()
 {
 	Super::BeginPlay();
@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Performance/EffectPoolSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Shooter/Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Pool Hits"), STAT_EffectPoolHits, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Pool Misses"), STAT_EffectPoolMisses, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Live Components"), STAT_EffectPoolLive, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Pool Peak Live Components"), STAT_EffectPoolPeakLive, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Effect Pool Spawn"), STAT_EffectPoolSpawn, STATGROUP_Shooter);
+
+static FAutoConsoleCommandWithWorld EffectPoolDumpCommand(
+	TEXT("Shooter.EffectPool.Dump"),
+	TEXT("Log the hits, misses and peak live components of every effect pool."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UEffectPoolSubsystem* EffectPoolSubsystem = World ? World->GetSubsystem<UEffectPoolSubsystem>() : nullptr;
+		if (EffectPoolSubsystem)
+		{
+			EffectPoolSubsystem->DumpStats();
+		}
+	}));
+
+void UEffectPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (const FEffectPoolSize& PoolSize : PoolSizes)
+	{
+		MaxPoolSizeByPath.Add(PoolSize.Template.ToSoftObjectPath(), PoolSize.MaxPoolSize);
+	}
+}
+
+void UEffectPoolSubsystem::Deinitialize()
+{
+	// The components belong to the world and are destroyed with it
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UEffectPoolSubsystem::SpawnEffectAtLocation(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	return SpawnEffect(Template, FTransform(Rotation, Location));
+}
+
+UParticleSystemComponent* UEffectPoolSubsystem::SpawnEffect(UParticleSystem* Template, const FTransform& Transform)
+{
+	if (Template == nullptr || GetWorld() == nullptr)
+	{
+		return nullptr;
+	}
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EffectPoolSpawn);
+
+	FEffectPool& Pool = GetPool(Template);
+
+	UParticleSystemComponent* Component = nullptr;
+	while (Component == nullptr && Pool.FreeComponents.Num() > 0)
+	{
+		Component = Pool.FreeComponents.Pop(false);
+		if (Component && Component->IsPendingKill())
+		{
+			Component = nullptr;
+		}
+	}
+
+	if (Component)
+	{
+		++Pool.Hits;
+		INC_DWORD_STAT(STAT_EffectPoolHits);
+	}
+	else
+	{
+		Component = CreateComponent(Template);
+		++Pool.Misses;
+		INC_DWORD_STAT(STAT_EffectPoolMisses);
+	}
+
+	Component->SetWorldTransform(Transform);
+	Component->ActivateSystem(true);
+
+	++Pool.LiveCount;
+	Pool.PeakLiveCount = FMath::Max(Pool.PeakLiveCount, Pool.LiveCount);
+	++TotalLiveCount;
+	if (TotalLiveCount > PeakTotalLiveCount)
+	{
+		PeakTotalLiveCount = TotalLiveCount;
+		SET_DWORD_STAT(STAT_EffectPoolPeakLive, PeakTotalLiveCount);
+	}
+	INC_DWORD_STAT(STAT_EffectPoolLive);
+
+	return Component;
+}
+
+UParticleSystemComponent* UEffectPoolSubsystem::CreateComponent(UParticleSystem* Template)
+{
+	UWorld* World = GetWorld();
+	AWorldSettings* WorldSettings = World->GetWorldSettings();
+
+	// Same setup as UGameplayStatics::SpawnEmitterAtLocation, except that the component survives finishing
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(WorldSettings ? static_cast<UObject*>(WorldSettings) : static_cast<UObject*>(World));
+	Component->bAutoDestroy = false;
+	Component->bAutoActivate = false;
+	Component->bAllowAnyoneToDestroyMe = true;
+	Component->SecondsBeforeInactive = 0.f;
+	Component->SetTemplate(Template);
+	Component->OnSystemFinished.AddDynamic(this, &UEffectPoolSubsystem::OnEffectFinished);
+	Component->RegisterComponentWithWorld(World);
+
+	return Component;
+}
+
+void UEffectPoolSubsystem::OnEffectFinished(UParticleSystemComponent* Component)
+{
+	FEffectPool* Pool = Component ? Pools.Find(Component->Template) : nullptr;
+	if (Pool == nullptr)
+	{
+		return;
+	}
+
+	--Pool->LiveCount;
+	--TotalLiveCount;
+	DEC_DWORD_STAT(STAT_EffectPoolLive);
+
+	if (Pool->FreeComponents.Num() < Pool->MaxPoolSize)
+	{
+		Pool->FreeComponents.Add(Component);
+	}
+	else
+	{
+		Component->DestroyComponent();
+	}
+}
+
+FEffectPool& UEffectPoolSubsystem::GetPool(UParticleSystem* Template)
+{
+	FEffectPool* Pool = Pools.Find(Template);
+	if (Pool == nullptr)
+	{
+		Pool = &Pools.Add(Template);
+
+		const int32* MaxPoolSize = MaxPoolSizeByPath.Find(FSoftObjectPath(Template));
+		Pool->MaxPoolSize = MaxPoolSize ? *MaxPoolSize : DefaultMaxPoolSize;
+	}
+	return *Pool;
+}
+
+void UEffectPoolSubsystem::DumpStats() const
+{
+	UE_LOG(LogShooter, Log, TEXT("Effect pools: %d live components, %d at peak"), TotalLiveCount, PeakTotalLiveCount);
+
+	for (const auto& PoolPair : Pools)
+	{
+		const FEffectPool& Pool = PoolPair.Value;
+		const int32 Spawns = Pool.Hits + Pool.Misses;
+		const float HitRate = Spawns > 0 ? 100.f * Pool.Hits / Spawns : 0.f;
+
+		UE_LOG(LogShooter, Log, TEXT("  %s: %d hits, %d misses (%.1f%% hit rate), %d live, %d peak live, %d free of %d"),
+			*GetNameSafe(PoolPair.Key),
+			Pool.Hits,
+			Pool.Misses,
+			HitRate,
+			Pool.LiveCount,
+			Pool.PeakLiveCount,
+			Pool.FreeComponents.Num(),
+			Pool.MaxPoolSize);
+	}
+}
@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Performance/TelemetrySubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/AI/Enemy.h"
+#include "UI/HitNumberManager.h"
+#include "UI/ShooterHUD.h"
+
+bool GShooterTelemetryEnabled = false;
+
+static FAutoConsoleVariableRef CVarTelemetryEnable(
+	TEXT("Shooter.Telemetry.Enable"),
+	GShooterTelemetryEnabled,
+	TEXT("When true, gameplay events are recorded into the telemetry ring buffer."));
+
+static FAutoConsoleCommandWithWorldAndArgs TelemetryDumpCommand(
+	TEXT("Shooter.Telemetry.Dump"),
+	TEXT("Write the telemetry of the last seconds to a CSV file in Saved/Telemetry. Optional argument: seconds, 10 by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UTelemetrySubsystem* TelemetrySubsystem = World ? World->GetSubsystem<UTelemetrySubsystem>() : nullptr;
+		if (TelemetrySubsystem)
+		{
+			const float Seconds = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.f;
+			const FString Path = TelemetrySubsystem->DumpToCsv(Seconds);
+			UE_LOG(LogShooter, Log, TEXT("Telemetry of the last %.1f s written to %s"), Seconds, Path.IsEmpty() ? TEXT("nowhere") : *Path);
+		}
+	}));
+
+UTelemetrySubsystem::UTelemetrySubsystem() :
+	Capacity(65536),
+	IndexMask(0),
+	WriteIndex(0)
+{
+
+}
+
+void UTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const int32 SlotCount = FMath::RoundUpToPowerOfTwo(FMath::Max(Capacity, 1024));
+	Slots.SetNumZeroed(SlotCount);
+	IndexMask = SlotCount - 1;
+}
+
+bool UTelemetrySubsystem::IsTickable() const
+{
+	return GShooterTelemetryEnabled;
+}
+
+ETickableTickType UTelemetrySubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UTelemetrySubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTelemetrySubsystem, STATGROUP_Tickables);
+}
+
+void UTelemetrySubsystem::Tick(float DeltaTime)
+{
+	SampleGauges();
+}
+
+void UTelemetrySubsystem::RecordEnabled(const UWorld* World, const ETelemetryEvent Event, const float Value)
+{
+	// World subsystems are only added when the world is created, so the lookup is safe from any thread
+	UTelemetrySubsystem* TelemetrySubsystem = World ? World->GetSubsystem<UTelemetrySubsystem>() : nullptr;
+	if (TelemetrySubsystem)
+	{
+		TelemetrySubsystem->Push(Event, Value);
+	}
+}
+
+void UTelemetrySubsystem::Push(const ETelemetryEvent Event, const float Value)
+{
+	if (Slots.Num() == 0)
+	{
+		return;
+	}
+
+	// Claim a slot, then mark it as being written so a concurrent dump skips it
+	const int64 Index = FPlatformAtomics::InterlockedIncrement(&WriteIndex) - 1;
+	FTelemetrySlot& Slot = Slots[Index & IndexMask];
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, 0);
+
+	Slot.Record.Seconds = FPlatformTime::Seconds();
+	Slot.Record.Frame = static_cast<uint32>(GFrameCounter);
+	Slot.Record.Value = Value;
+	Slot.Record.Event = Event;
+
+	// Publish; the exchange is a full barrier, so the record is visible before the sequence
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Index + 1);
+}
+
+void UTelemetrySubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	// The gauges only drop destroyed enemies while telemetry is on, so also drop them whenever the array would grow
+	if (Enemies.Num() == Enemies.Max())
+	{
+		Enemies.RemoveAllSwap([](const TWeakObjectPtr<AEnemy>& RegisteredEnemy) { return !RegisteredEnemy.IsValid(); }, false);
+	}
+	Enemies.Add(Enemy);
+}
+
+void UTelemetrySubsystem::SampleGauges()
+{
+	int32 EnemiesAlive = 0;
+	for (int32 Index = Enemies.Num() - 1; Index >= 0; --Index)
+	{
+		const AEnemy* Enemy = Enemies[Index].Get();
+		if (Enemy == nullptr)
+		{
+			Enemies.RemoveAtSwap(Index, 1, false);
+		}
+		else if (!Enemy->IsDying())
+		{
+			++EnemiesAlive;
+		}
+	}
+
+	// Hit numbers are the only widgets created during play; the rest of the HUD is fixed
+	int32 WidgetsAlive = 0;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const AShooterHUD* ShooterHUD = PlayerController ? PlayerController->GetHUD<AShooterHUD>() : nullptr;
+		if (ShooterHUD && ShooterHUD->GetHitNumberManager())
+		{
+			WidgetsAlive += ShooterHUD->GetHitNumberManager()->GetNumActiveHitNumbers();
+		}
+	}
+
+	Push(ETelemetryEvent::ETE_EnemiesAlive, EnemiesAlive);
+	Push(ETelemetryEvent::ETE_WidgetsAlive, WidgetsAlive);
+}
+
+void UTelemetrySubsystem::ReadRecords(TArray<FTelemetryRecord>& OutRecords) const
+{
+	const int64 EndIndex = FPlatformAtomics::AtomicRead(&WriteIndex);
+	const int64 StartIndex = FMath::Max<int64>(0, EndIndex - Slots.Num());
+
+	OutRecords.Reset(EndIndex - StartIndex);
+	for (int64 Index = StartIndex; Index < EndIndex; ++Index)
+	{
+		const FTelemetrySlot& Slot = Slots[Index & IndexMask];
+		if (FPlatformAtomics::AtomicRead(&Slot.Sequence) != Index + 1)
+		{
+			continue;
+		}
+
+		const FTelemetryRecord Record = Slot.Record;
+
+		// Skip records overwritten while they were copied
+		if (FPlatformAtomics::AtomicRead(&Slot.Sequence) == Index + 1)
+		{
+			OutRecords.Add(Record);
+		}
+	}
+}
+
+FString UTelemetrySubsystem::DumpToCsv(const float Seconds) const
+{
+	TArray<FTelemetryRecord> Records;
+	ReadRecords(Records);
+
+	/** Sums and gauges of one frame. */
+	struct FFrameRow
+	{
+		uint32 Frame = 0;
+		double Seconds = 0.0;
+		int32 ShotsFired = 0;
+		int32 TracesIssued = 0;
+		int32 DamageEvents = 0;
+		float DamageAmount = 0.f;
+		int32 Explosions = 0;
+		int32 ItemsTicking = 0;
+		int32 EnemiesAlive = 0;
+		int32 WidgetsAlive = 0;
+	};
+
+	// Records of one frame are mostly contiguous, but other threads can interleave
+	const double StartSeconds = FPlatformTime::Seconds() - Seconds;
+	TMap<uint32, FFrameRow> Rows;
+	for (const FTelemetryRecord& Record : Records)
+	{
+		if (Record.Seconds < StartSeconds)
+		{
+			continue;
+		}
+
+		FFrameRow& Row = Rows.FindOrAdd(Record.Frame);
+		Row.Frame = Record.Frame;
+		Row.Seconds = Row.Seconds > 0.0 ? FMath::Min(Row.Seconds, Record.Seconds) : Record.Seconds;
+
+		switch (Record.Event)
+		{
+		case ETelemetryEvent::ETE_ShotFired:
+			++Row.ShotsFired;
+			break;
+		case ETelemetryEvent::ETE_TraceIssued:
+			Row.TracesIssued += FMath::RoundToInt(Record.Value);
+			break;
+		case ETelemetryEvent::ETE_DamageEvent:
+			++Row.DamageEvents;
+			Row.DamageAmount += Record.Value;
+			break;
+		case ETelemetryEvent::ETE_Explosion:
+			++Row.Explosions;
+			break;
+		case ETelemetryEvent::ETE_ItemTick:
+			++Row.ItemsTicking;
+			break;
+		case ETelemetryEvent::ETE_EnemiesAlive:
+			Row.EnemiesAlive = FMath::RoundToInt(Record.Value);
+			break;
+		case ETelemetryEvent::ETE_WidgetsAlive:
+			Row.WidgetsAlive = FMath::RoundToInt(Record.Value);
+			break;
+		default:
+			break;
+		}
+	}
+	Rows.KeySort(TLess<uint32>());
+
+	FString Csv(TEXT("Frame,Seconds,ShotsFired,TracesIssued,DamageEvents,DamageAmount,Explosions,ItemsTicking,EnemiesAlive,WidgetsAlive\n"));
+	for (const auto& RowPair : Rows)
+	{
+		const FFrameRow& Row = RowPair.Value;
+		Csv += FString::Printf(TEXT("%u,%.4f,%d,%d,%d,%.1f,%d,%d,%d,%d\n"),
+			Row.Frame,
+			Row.Seconds - StartSeconds,
+			Row.ShotsFired,
+			Row.TracesIssued,
+			Row.DamageEvents,
+			Row.DamageAmount,
+			Row.Explosions,
+			Row.ItemsTicking,
+			Row.EnemiesAlive,
+			Row.WidgetsAlive);
+	}
+
+	const FString Path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), FString::Printf(TEXT("Telemetry-%s.csv"), *FDateTime::Now().ToString()));
+	return FFileHelper::SaveStringToFile(Csv, *Path) ? Path : FString();
+}
@@ -0,0 +1,376 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/Performance/TickThrottleSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Shooter/Shooter.h"
+#include "Shooter/Public/Items/Item.h"
+#include "Shooter/Public/Player/ShooterCharacter.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tick Throttle Near"), STAT_TickThrottleNear, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tick Throttle Mid"), STAT_TickThrottleMid, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tick Throttle Far"), STAT_TickThrottleFar, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tick Throttle Disabled"), STAT_TickThrottleDisabled, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Tick Throttle Update Buckets"), STAT_TickThrottleUpdateBuckets, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarTickThrottleEnable(
+	TEXT("Shooter.TickThrottle.Enable"),
+	1,
+	TEXT("When zero, every throttled actor ticks at its own rate again."));
+
+static FAutoConsoleCommandWithWorld TickThrottleDumpCommand(
+	TEXT("Shooter.TickThrottle.Dump"),
+	TEXT("Log the tick throttle bucket populations and the estimated tick time saved."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UTickThrottleSubsystem* TickThrottleSubsystem = World ? World->GetSubsystem<UTickThrottleSubsystem>() : nullptr;
+		if (TickThrottleSubsystem)
+		{
+			TickThrottleSubsystem->DumpStats();
+		}
+	}));
+
+void UTickThrottleSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PolicyClasses.Reset(Policies.Num());
+	for (const FTickThrottlePolicy& Policy : Policies)
+	{
+		UClass* PolicyClass = Policy.ActorClass.LoadSynchronous();
+		if (PolicyClass == nullptr)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Tick throttle policy class %s could not be loaded."), *Policy.ActorClass.ToString());
+		}
+		PolicyClasses.Add(PolicyClass);
+	}
+	PolicyStats.SetNum(Policies.Num());
+}
+
+void UTickThrottleSubsystem::Deinitialize()
+{
+	for (FThrottledActor& Entry : ThrottledActors)
+	{
+		RestoreActor(Entry);
+	}
+	ThrottledActors.Empty();
+	ThrottledActorIndices.Empty();
+	PolicyIndexByClass.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UTickThrottleSubsystem::IsTickable() const
+{
+	return ThrottledActors.Num() > 0;
+}
+
+ETickableTickType UTickThrottleSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UTickThrottleSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UTickThrottleSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTickThrottleSubsystem, STATGROUP_Tickables);
+}
+
+void UTickThrottleSubsystem::RegisterActor(AActor* Actor)
+{
+	if (Actor == nullptr || !Actor->PrimaryActorTick.bCanEverTick || ThrottledActorIndices.Contains(Actor))
+	{
+		return;
+	}
+
+	const int32 PolicyIndex = FindPolicyIndex(Actor->GetClass());
+	if (PolicyIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	ThrottledActorIndices.Add(Actor, ThrottledActors.Num());
+	FThrottledActor& Entry = ThrottledActors.AddDefaulted_GetRef();
+	Entry.Actor = Actor;
+	Entry.PolicyIndex = PolicyIndex;
+	Entry.BaseTickInterval = Actor->GetActorTickInterval();
+	++PolicyStats[PolicyIndex].BucketCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Near)];
+}
+
+int32 UTickThrottleSubsystem::FindPolicyIndex(UClass* Class)
+{
+	if (const int32* CachedIndex = PolicyIndexByClass.Find(Class))
+	{
+		return *CachedIndex;
+	}
+
+	// Walk up the hierarchy so the closest configured parent wins
+	int32 PolicyIndex = INDEX_NONE;
+	for (const UClass* SearchClass = Class; SearchClass && PolicyIndex == INDEX_NONE; SearchClass = SearchClass->GetSuperClass())
+	{
+		PolicyIndex = PolicyClasses.IndexOfByKey(SearchClass);
+	}
+
+	PolicyIndexByClass.Add(Class, PolicyIndex);
+	return PolicyIndex;
+}
+
+void UTickThrottleSubsystem::Tick(float DeltaTime)
+{
+	const bool bEnabled = CVarTickThrottleEnable.GetValueOnGameThread() != 0;
+	if (!bEnabled)
+	{
+		if (bWasEnabled)
+		{
+			for (FThrottledActor& Entry : ThrottledActors)
+			{
+				RestoreActor(Entry);
+			}
+			for (FPolicyStats& Stats : PolicyStats)
+			{
+				Stats = FPolicyStats();
+			}
+			bWasEnabled = false;
+		}
+		return;
+	}
+	bWasEnabled = true;
+
+	AccumulateSkippedTicks(DeltaTime);
+
+	TimeUntilBucketUpdate -= DeltaTime;
+	if (TimeUntilBucketUpdate > 0.f)
+	{
+		return;
+	}
+	TimeUntilBucketUpdate = BucketUpdateInterval;
+
+	const AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+	if (ShooterCharacter)
+	{
+		UpdateBuckets(ShooterCharacter->GetActorLocation());
+	}
+}
+
+void UTickThrottleSubsystem::UpdateBuckets(const FVector& ViewLocation)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_TickThrottleUpdateBuckets);
+
+	for (FPolicyStats& Stats : PolicyStats)
+	{
+		FMemory::Memzero(Stats.BucketCounts);
+		FMemory::Memzero(Stats.TickingCounts);
+		Stats.DisabledCount = 0;
+	}
+
+	int32 TotalCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_MAX)] = {};
+	int32 TotalDisabled = 0;
+
+	for (int32 Index = ThrottledActors.Num() - 1; Index >= 0; --Index)
+	{
+		FThrottledActor& Entry = ThrottledActors[Index];
+		const AActor* Actor = Entry.Actor.Get();
+		if (Actor == nullptr || Actor->IsPendingKill())
+		{
+			RemoveThrottledActor(Index);
+			continue;
+		}
+
+		const FTickThrottlePolicy& Policy = Policies[Entry.PolicyIndex];
+		const float DistanceSquared = FVector::DistSquared(Actor->GetActorLocation(), ViewLocation);
+
+		uint8 Bucket = static_cast<uint8>(ETickThrottleBucket::ETTB_Near);
+		if (DistanceSquared > FMath::Square(Policy.FarDistance))
+		{
+			Bucket = static_cast<uint8>(ETickThrottleBucket::ETTB_Far);
+		}
+		else if (DistanceSquared > FMath::Square(Policy.NearDistance))
+		{
+			Bucket = static_cast<uint8>(ETickThrottleBucket::ETTB_Mid);
+		}
+
+		if (Policy.bDemoteWhenNotRendered && !Actor->WasRecentlyRendered(RecentlyRenderedTolerance))
+		{
+			Bucket = FMath::Min<uint8>(Bucket + 1, static_cast<uint8>(ETickThrottleBucket::ETTB_Far));
+		}
+
+		ApplyBucket(Entry, static_cast<ETickThrottleBucket>(Bucket));
+
+		FPolicyStats& Stats = PolicyStats[Entry.PolicyIndex];
+		++Stats.BucketCounts[Bucket];
+		++TotalCounts[Bucket];
+		if (Actor->IsActorTickEnabled())
+		{
+			++Stats.TickingCounts[Bucket];
+		}
+		if (Entry.bTickDisabledByThrottle)
+		{
+			++Stats.DisabledCount;
+			++TotalDisabled;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_TickThrottleNear, TotalCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Near)]);
+	SET_DWORD_STAT(STAT_TickThrottleMid, TotalCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Mid)]);
+	SET_DWORD_STAT(STAT_TickThrottleFar, TotalCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Far)]);
+	SET_DWORD_STAT(STAT_TickThrottleDisabled, TotalDisabled);
+}
+
+void UTickThrottleSubsystem::RemoveThrottledActor(const int32 Index)
+{
+	ThrottledActorIndices.Remove(ThrottledActors[Index].Actor);
+	ThrottledActors.RemoveAtSwap(Index, 1, false);
+	if (ThrottledActors.IsValidIndex(Index))
+	{
+		ThrottledActorIndices.Add(ThrottledActors[Index].Actor, Index);
+	}
+}
+
+void UTickThrottleSubsystem::ApplyBucket(FThrottledActor& Entry, const ETickThrottleBucket NewBucket)
+{
+	if (Entry.Bucket == NewBucket)
+	{
+		return;
+	}
+	Entry.Bucket = NewBucket;
+
+	AActor* Actor = Entry.Actor.Get();
+	const FTickThrottlePolicy& Policy = Policies[Entry.PolicyIndex];
+
+	if (NewBucket == ETickThrottleBucket::ETTB_Far && Policy.bDisableTickWhenFar)
+	{
+		// Leave actors that already turned their own tick off alone
+		if (Actor->IsActorTickEnabled())
+		{
+			Actor->SetActorTickEnabled(false);
+			Entry.bTickDisabledByThrottle = true;
+		}
+		return;
+	}
+
+	if (Entry.bTickDisabledByThrottle)
+	{
+		Actor->SetActorTickEnabled(ActorWantsTick(Actor));
+		Entry.bTickDisabledByThrottle = false;
+	}
+
+	switch (NewBucket)
+	{
+	case ETickThrottleBucket::ETTB_Near:
+		Actor->SetActorTickInterval(Entry.BaseTickInterval);
+		break;
+	case ETickThrottleBucket::ETTB_Mid:
+		Actor->SetActorTickInterval(FMath::Max(Entry.BaseTickInterval, Policy.MidTickInterval));
+		break;
+	case ETickThrottleBucket::ETTB_Far:
+		Actor->SetActorTickInterval(FMath::Max(Entry.BaseTickInterval, Policy.FarTickInterval));
+		break;
+	default:
+		break;
+	}
+}
+
+void UTickThrottleSubsystem::OnActorTickChanged(AActor* Actor)
+{
+	const int32* Index = ThrottledActorIndices.Find(Actor);
+	if (Index == nullptr)
+	{
+		return;
+	}
+	FThrottledActor& Entry = ThrottledActors[*Index];
+
+	// The actor decides its own tick from now on
+	Entry.bTickDisabledByThrottle = false;
+
+	const FTickThrottlePolicy& Policy = Policies[Entry.PolicyIndex];
+	if (Entry.Bucket == ETickThrottleBucket::ETTB_Far && Policy.bDisableTickWhenFar && Actor->IsActorTickEnabled() && CVarTickThrottleEnable.GetValueOnGameThread() != 0)
+	{
+		Actor->SetActorTickEnabled(false);
+		Entry.bTickDisabledByThrottle = true;
+	}
+}
+
+bool UTickThrottleSubsystem::ActorWantsTick(const AActor* Actor)
+{
+	const AItem* Item = Cast<AItem>(Actor);
+	return Item == nullptr || Item->WantsTick();
+}
+
+void UTickThrottleSubsystem::RestoreActor(FThrottledActor& Entry)
+{
+	AActor* Actor = Entry.Actor.Get();
+	if (Actor)
+	{
+		Actor->SetActorTickInterval(Entry.BaseTickInterval);
+		if (Entry.bTickDisabledByThrottle)
+		{
+			Actor->SetActorTickEnabled(ActorWantsTick(Actor));
+		}
+	}
+	Entry.Bucket = ETickThrottleBucket::ETTB_Near;
+	Entry.bTickDisabledByThrottle = false;
+}
+
+void UTickThrottleSubsystem::AccumulateSkippedTicks(const float DeltaTime)
+{
+	if (DeltaTime <= 0.f)
+	{
+		return;
+	}
+	TrackedTime += DeltaTime;
+
+	// A full rate actor ticks once per frame, a throttled one DeltaTime / Interval times
+	const auto SkippedFraction = [DeltaTime](const float TickInterval)
+	{
+		return TickInterval > DeltaTime ? 1.0 - DeltaTime / TickInterval : 0.0;
+	};
+
+	for (int32 PolicyIndex = 0; PolicyIndex < Policies.Num(); ++PolicyIndex)
+	{
+		const FTickThrottlePolicy& Policy = Policies[PolicyIndex];
+		FPolicyStats& Stats = PolicyStats[PolicyIndex];
+
+		// Actors with their own tick off would not have ticked anyway, so only the ticks the subsystem held back count
+		const int32 MidTickingCount = Stats.TickingCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Mid)];
+		const int32 FarTickingCount = Stats.TickingCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Far)];
+
+		Stats.TicksSkipped += MidTickingCount * SkippedFraction(Policy.MidTickInterval);
+		Stats.TicksSkipped += FarTickingCount * SkippedFraction(Policy.FarTickInterval);
+		Stats.TicksSkipped += Stats.DisabledCount;
+	}
+}
+
+void UTickThrottleSubsystem::DumpStats() const
+{
+	UE_LOG(LogShooter, Log, TEXT("Tick throttle: %d actors over %.1f seconds (%s)"),
+		ThrottledActors.Num(), TrackedTime, bWasEnabled ? TEXT("enabled") : TEXT("disabled"));
+
+	double TotalSavedMilliseconds = 0.0;
+	for (int32 PolicyIndex = 0; PolicyIndex < Policies.Num(); ++PolicyIndex)
+	{
+		const FTickThrottlePolicy& Policy = Policies[PolicyIndex];
+		const FPolicyStats& Stats = PolicyStats[PolicyIndex];
+
+		const double TicksSkippedPerSecond = TrackedTime > 0.0 ? Stats.TicksSkipped / TrackedTime : 0.0;
+		const double SavedMillisecondsPerSecond = TicksSkippedPerSecond * Policy.EstimatedTickCostMicroseconds / 1000.0;
+		TotalSavedMilliseconds += Stats.TicksSkipped * Policy.EstimatedTickCostMicroseconds / 1000.0;
+
+		UE_LOG(LogShooter, Log, TEXT("  %s: Near %d, Mid %d, Far %d (%d disabled), %.0f ticks skipped, %.1f ticks/s, ~%.3f ms/s saved"),
+			*Policy.ActorClass.GetAssetName(),
+			Stats.BucketCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Near)],
+			Stats.BucketCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Mid)],
+			Stats.BucketCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_Far)],
+			Stats.DisabledCount,
+			Stats.TicksSkipped,
+			TicksSkippedPerSecond,
+			SavedMillisecondsPerSecond);
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("  Estimated tick time saved: %.2f ms in total"), TotalSavedMilliseconds);
+}
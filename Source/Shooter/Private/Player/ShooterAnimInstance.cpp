@@ -3,9 +3,80 @@
 #include "Shooter/Public/Player/ShooterAnimInstance.h"
 
 #include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "Items/Weapon.h"
+#include "Shooter/Shooter.h"
 #include "Shooter/Public/Player/ShooterCharacter.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_CYCLE_STAT(TEXT("Shooter Anim Game Thread Update"), STAT_ShooterAnimGameThreadUpdate, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Shooter Anim Snapshot"), STAT_ShooterAnimSnapshot, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Shooter Anim Worker Update"), STAT_ShooterAnimWorkerUpdate, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarShooterAnimThreadSafeUpdate(
+	TEXT("Shooter.Anim.ThreadSafeUpdate"),
+	1,
+	TEXT("When non-zero, the character animation properties are updated on a worker thread instead of from the event graph."));
+
+static FAutoConsoleCommandWithWorldAndArgs ShooterAnimBenchmarkCommand(
+	TEXT("Shooter.Anim.Benchmark"),
+	TEXT("Time the game thread cost of the character animation update with and without the worker thread path. Optional argument: iterations."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+
+		for (TObjectIterator<UShooterAnimInstance> It; It; ++It)
+		{
+			if (It->GetWorld() != World || It->IsTemplate())
+			{
+				continue;
+			}
+
+			double GameThreadUpdateSeconds = 0.0;
+			double SnapshotSeconds = 0.0;
+			It->RunUpdateBenchmark(Iterations, GameThreadUpdateSeconds, SnapshotSeconds);
+
+			UE_LOG(LogShooter, Log, TEXT("%s: game thread update %.3f us, worker thread path %.3f us on the game thread (%d iterations)"),
+				*It->GetName(),
+				GameThreadUpdateSeconds * 1000000.0 / Iterations,
+				SnapshotSeconds * 1000000.0 / Iterations,
+				Iterations);
+		}
+	}));
+
+FShooterAnimInstanceProxy::FShooterAnimInstanceProxy(UAnimInstance* InAnimInstance) :
+	FAnimInstanceProxy(InAnimInstance),
+	bHasSnapshot(false)
+{
+	
+}
+
+void FShooterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const UShooterAnimInstance* ShooterAnimInstance = Cast<UShooterAnimInstance>(InAnimInstance);
+	bHasSnapshot = ShooterAnimInstance && ShooterAnimInstance->ShooterCharacter && UShooterAnimInstance::IsThreadSafeUpdateEnabled();
+	if (bHasSnapshot)
+	{
+		SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterAnimSnapshot);
+		ShooterAnimInstance->TakeSnapshot(Snapshot);
+	}
+}
+
+void FShooterAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	FAnimInstanceProxy::Update(DeltaSeconds);
+
+	// The game thread does not touch the animation properties until the parallel update is done
+	UShooterAnimInstance* ShooterAnimInstance = Cast<UShooterAnimInstance>(GetAnimInstanceObject());
+	if (bHasSnapshot && ShooterAnimInstance)
+	{
+		SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterAnimWorkerUpdate);
+		ShooterAnimInstance->UpdateFromSnapshot(Snapshot, DeltaSeconds);
+	}
+}
 
 UShooterAnimInstance::UShooterAnimInstance() :
 	Speed(0.f),
@@ -17,6 +88,8 @@ UShooterAnimInstance::UShooterAnimInstance() :
 	TIPCharacterYaw(0.f),
 	TIPCharacterYawLastFrame(0.f),
 	RootYawOffset(0.f),
+	TurningCurveHandle(INDEX_NONE),
+	RotationCurveHandle(INDEX_NONE),
 	bReloading(false),
 	OffsetState(EOffsetState::EOS_Hip),
 	CharacterRotation(FRotator(0.f)),
@@ -36,37 +109,125 @@ void UShooterAnimInstance::NativeInitializeAnimation()
 	Super::NativeInitializeAnimation();
 
 	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+
+	CurveCache.Reset();
+	TurningCurveHandle = CurveCache.Resolve(this, TEXT("Turning"));
+	RotationCurveHandle = CurveCache.Resolve(this, TEXT("Rotation"));
+}
+
+FAnimInstanceProxy* UShooterAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FShooterAnimInstanceProxy(this);
+}
+
+bool UShooterAnimInstance::IsThreadSafeUpdateEnabled()
+{
+	return CVarShooterAnimThreadSafeUpdate.GetValueOnGameThread() != 0;
 }
 
 void UShooterAnimInstance::UpdateAnimationProperties(const float DeltaTime)
 {
+	// FShooterAnimInstanceProxy does the update on a worker thread instead
+	if (ShooterCharacter == nullptr || IsThreadSafeUpdateEnabled())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterAnimGameThreadUpdate);
+
+	FShooterAnimSnapshot Snapshot;
+	TakeSnapshot(Snapshot);
+	UpdateFromSnapshot(Snapshot, DeltaTime);
+}
+
+void UShooterAnimInstance::RunUpdateBenchmark(const int32 Iterations, double& OutGameThreadUpdateSeconds, double& OutSnapshotSeconds)
+{
+	OutGameThreadUpdateSeconds = 0.0;
+	OutSnapshotSeconds = 0.0;
 	if (ShooterCharacter == nullptr)
 	{
 		return;
 	}
 
-	bCrouching = IsCharacterCrouching();
-	bReloading = IsCharacterReloading();
-	bEquipping = IsCharacterEquipping();
-	bIsInAir = IsCharacterInTheAir();
-	bIsAccelerating = IsCharacterAccelerating();
-	bAiming = IsCharacterAiming();
-	bShouldUseFABRIK = ShouldUseFABRIK();
+	const float DeltaTime = GetWorld() ? GetWorld()->GetDeltaSeconds() : 1.f / 60.f;
+	FShooterAnimSnapshot Snapshot;
+
+	double StartSeconds;
+	{
+		// The update carries turn in place and lean state from frame to frame; put it back so the next real update does not pop
+		TGuardValue<float> TIPCharacterYawGuard(TIPCharacterYaw, TIPCharacterYaw);
+		TGuardValue<float> TIPCharacterYawLastFrameGuard(TIPCharacterYawLastFrame, TIPCharacterYawLastFrame);
+		TGuardValue<float> RootYawOffsetGuard(RootYawOffset, RootYawOffset);
+		TGuardValue<float> RotationCurveGuard(RotationCurve, RotationCurve);
+		TGuardValue<float> RotationCurveLastFrameGuard(RotationCurveLastFrame, RotationCurveLastFrame);
+		TGuardValue<FRotator> CharacterRotationGuard(CharacterRotation, CharacterRotation);
+		TGuardValue<FRotator> CharacterRotationLastFrameGuard(CharacterRotationLastFrame, CharacterRotationLastFrame);
+		TGuardValue<float> YawDeltaGuard(YawDelta, YawDelta);
+		TGuardValue<float> LastMovementOffsetYawGuard(LastMovementOffsetYaw, LastMovementOffsetYaw);
+		TGuardValue<EWeaponType> EquippedWeaponTypeGuard(EquippedWeaponType, EquippedWeaponType);
+
+		StartSeconds = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			TakeSnapshot(Snapshot);
+			UpdateFromSnapshot(Snapshot, DeltaTime);
+		}
+		OutGameThreadUpdateSeconds = FPlatformTime::Seconds() - StartSeconds;
+	}
+
+	StartSeconds = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < Iterations; ++Index)
+	{
+		TakeSnapshot(Snapshot);
+	}
+	OutSnapshotSeconds = FPlatformTime::Seconds() - StartSeconds;
+}
+
+void UShooterAnimInstance::TakeSnapshot(FShooterAnimSnapshot& OutSnapshot) const
+{
+	OutSnapshot.Velocity = ShooterCharacter->GetVelocity();
+	OutSnapshot.AimRotation = ShooterCharacter->GetBaseAimRotation();
+	OutSnapshot.ActorRotation = ShooterCharacter->GetActorRotation();
+	OutSnapshot.bCrouching = IsCharacterCrouching();
+	OutSnapshot.bReloading = IsCharacterReloading();
+	OutSnapshot.bEquipping = IsCharacterEquipping();
+	OutSnapshot.bIsInAir = IsCharacterInTheAir();
+	OutSnapshot.bIsAccelerating = IsCharacterAccelerating();
+	OutSnapshot.bAiming = IsCharacterAiming();
+	OutSnapshot.bShouldUseFABRIK = ShouldUseFABRIK();
+
+	const AWeapon* EquippedWeapon = ShooterCharacter->GetEquippedWeapon();
+	OutSnapshot.bHasEquippedWeapon = EquippedWeapon != nullptr;
+	OutSnapshot.EquippedWeaponType = EquippedWeapon ? EquippedWeapon->GetWeaponType() : EWeaponType::EWT_MAX;
+
+	OutSnapshot.TurningCurveValue = CurveCache.GetValue(this, TurningCurveHandle);
+	OutSnapshot.RotationCurveValue = CurveCache.GetValue(this, RotationCurveHandle);
+}
+
+void UShooterAnimInstance::UpdateFromSnapshot(const FShooterAnimSnapshot& Snapshot, const float DeltaTime)
+{
+	bCrouching = Snapshot.bCrouching;
+	bReloading = Snapshot.bReloading;
+	bEquipping = Snapshot.bEquipping;
+	bIsInAir = Snapshot.bIsInAir;
+	bIsAccelerating = Snapshot.bIsAccelerating;
+	bAiming = Snapshot.bAiming;
+	bShouldUseFABRIK = Snapshot.bShouldUseFABRIK;
 	
-	SetCharacterSpeed(Speed);
+	SetCharacterSpeed(Snapshot.Velocity, Speed);
 
-	CalculateMovementOffsetYaw();
+	CalculateMovementOffsetYaw(Snapshot);
 
 	SetOffsetState();
 
-	// Check if ShooterCharacter has a valid EquippedWeapon
-	if (ShooterCharacter->GetEquippedWeapon())
+	// Keep the last weapon type while no weapon is equipped
+	if (Snapshot.bHasEquippedWeapon)
 	{
-		EquippedWeaponType = ShooterCharacter->GetEquippedWeapon()->GetWeaponType();
+		EquippedWeaponType = Snapshot.EquippedWeaponType;
 	}
 	
-	TurnInPlace();
-	Lean(DeltaTime);
+	TurnInPlace(Snapshot);
+	Lean(Snapshot, DeltaTime);
 }
 
 bool UShooterAnimInstance::IsCharacterCrouching() const
@@ -104,21 +265,18 @@ bool UShooterAnimInstance::ShouldUseFABRIK() const
 	return ShooterCharacter->GetCombatState() == ECombatState::ECS_Unoccupied || ShooterCharacter->GetCombatState() == ECombatState::ECS_FireTimerInProgress;
 }
 
-void UShooterAnimInstance::SetCharacterSpeed(float& CharacterSpeed) const
+void UShooterAnimInstance::SetCharacterSpeed(const FVector& Velocity, float& CharacterSpeed)
 {
 	// Get the lateral speed of the character from velocity
-	FVector Velocity = ShooterCharacter->GetVelocity();
-	Velocity.Z = 0;
-	CharacterSpeed = Velocity.Size();
+	CharacterSpeed = FVector(Velocity.X, Velocity.Y, 0.f).Size();
 }
 
-void UShooterAnimInstance::CalculateMovementOffsetYaw()
+void UShooterAnimInstance::CalculateMovementOffsetYaw(const FShooterAnimSnapshot& Snapshot)
 {
-	const FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
-	const FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ShooterCharacter->GetVelocity());
-	MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation,AimRotation).Yaw;
+	const FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(Snapshot.Velocity);
+	MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, Snapshot.AimRotation).Yaw;
 
-	if (ShooterCharacter->GetVelocity().Size() > 0.f)
+	if (Snapshot.Velocity.Size() > 0.f)
 	{
 		LastMovementOffsetYaw = MovementOffsetYaw;
 	}
@@ -134,7 +292,7 @@ void UShooterAnimInstance::SetOffsetState()
 	{
 		OffsetState = EOffsetState::EOS_InAir;
 	}
-	else if (ShooterCharacter->GetAiming())
+	else if (bAiming)
 	{
 		OffsetState = EOffsetState::EOS_Aiming;
 	}
@@ -144,20 +302,15 @@ void UShooterAnimInstance::SetOffsetState()
 	}
 }
 
-void UShooterAnimInstance::TurnInPlace()
+void UShooterAnimInstance::TurnInPlace(const FShooterAnimSnapshot& Snapshot)
 {
-	if (ShooterCharacter == nullptr)
-	{
-		return;
-	}
-
-	Pitch = ShooterCharacter->GetBaseAimRotation().Pitch;
+	Pitch = Snapshot.AimRotation.Pitch;
 	
 	if (Speed > 0 || bIsInAir)
 	{
 		// Don't want to turn in place; Character is moving
 		RootYawOffset = 0.f;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
 		RotationCurveLastFrame = 0.f;
 		RotationCurve = 0.f;
@@ -165,19 +318,19 @@ void UShooterAnimInstance::TurnInPlace()
 	else
 	{
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
 		const float TIPYawDelta{ TIPCharacterYaw - TIPCharacterYawLastFrame };
 
 		// Root Yaw Offset, updated and clamped to [-180, 180]
 		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPYawDelta);
 
 		// 1.0 if turning, 0.0 if not
-		const float Turning{ GetCurveValue(TEXT("Turning")) };
+		const float Turning{ Snapshot.TurningCurveValue };
 		if (Turning > 0)
 		{
 			bTurningInPlace = true;
 			RotationCurveLastFrame = RotationCurve;
-			RotationCurve = GetCurveValue(TEXT("Rotation"));
+			RotationCurve = Snapshot.RotationCurveValue;
 			const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 
 			// RootYawOffset > 0, -> Turning Left. RootYawOffset < 0, -> Turning Right.
@@ -217,15 +370,10 @@ void UShooterAnimInstance::SetRecoilWeight()
 	}
 }
 
-void UShooterAnimInstance::Lean(float DeltaTime)
+void UShooterAnimInstance::Lean(const FShooterAnimSnapshot& Snapshot, float DeltaTime)
 {
-	if (ShooterCharacter == nullptr)
-	{
-		return;
-	}
-
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ShooterCharacter->GetActorRotation();
+	CharacterRotation = Snapshot.ActorRotation;
 
 	const FRotator Delta = UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame);
 	const float Target = Delta.Yaw / DeltaTime;
@@ -4,6 +4,8 @@
 
 #include "AI/EnemyAIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "Combat/HitscanSubsystem.h"
+#include "Combat/ProjectileSubsystem.h"
 #include "Shooter/Public/AI/Enemy.h"
 #include "Camera/CameraComponent.h"
 #include "Components/BoxComponent.h"
@@ -16,12 +18,30 @@
 #include "Engine/SkeletalMeshSocket.h"
 #include "Interfaces/BulletHitInterface.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/ScopeExit.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "Performance/EffectPoolSubsystem.h"
+#include "Performance/TelemetrySubsystem.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 #include "Shooter/Shooter.h"
 #include "Shooter/Public/Items//Item.h"
 #include "Shooter/Public/Items//Weapon.h"
 #include "Shooter/Public/Items/Ammo.h"
+#include "Shooter/Public/Items/PickupPoolSubsystem.h"
+#include "Shooter/Public/Items/Shotgun.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Fired"), STAT_ShotsFired, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sub Frame Shots"), STAT_SubFrameShots, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Send Bullet"), STAT_SendBullet, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Trace For Items"), STAT_TraceForItems, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Crosshair Spread"), STAT_CrosshairSpread, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Shooter Character Take Damage"), STAT_ShooterCharacterTakeDamage, STATGROUP_Shooter);
+
+namespace ShooterCharacter
+{
+	/** Bound on the shots fired in one frame, for hitches and weapons with no fire rate. */
+	static constexpr int32 MaxAutoFireShotsPerFrame = 16;
+}
 
 AShooterCharacter::AShooterCharacter() :
 	// Base Rates for turning/looking up
@@ -53,9 +73,17 @@ AShooterCharacter::AShooterCharacter() :
 	// Bullet fire timer variables
 	bFireButtonPressed(false),
 	bShouldFire(true),
+	AutoFireCooldown(0.f),
+	PreviousCrosshairPosition(FVector::ZeroVector),
+	PreviousCrosshairDirection(FVector::ForwardVector),
+	PreviousAimFrame(0),
+	AutoFireArmedFrame(0),
+	bUpdatingAutoFire(false),
 	// Automatic fire variables
 	ShootTimeDuration(0.05f),
 	bFiringBullet(false),
+	BulletsSent(0),
+	SendBulletSeconds(0.0),
 	// Item trace variables
 	bShouldTraceForItems(false),
 	CameraInterpolationDistance(250.f),
@@ -163,6 +191,8 @@ void AShooterCharacter::BeginPlay()
 	InitializeAmmoMap();
 	GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
 	InitializeInterpolationLocations();
+
+	ItemTraceDelegate.BindUObject(this, &AShooterCharacter::OnItemTraceCompleted);
 }
 
 void AShooterCharacter::EquipWeapon(AWeapon* WeaponToEquip, const bool bSwapping)
@@ -235,6 +265,7 @@ void AShooterCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 	
+	UpdateAutoFire(DeltaTime);
 	InterpCapsuleHalfHeight(DeltaTime);
 	CameraInterpolationZoom(DeltaTime);
 	SetLookUpRates();
@@ -285,6 +316,8 @@ void AShooterCharacter::SetLookUpRates()
 
 void AShooterCharacter::CalculateCrosshairSpread(const float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_CrosshairSpread);
+
 	const FVector2D WalkSpeedRange { 0.f, 600.f };
 	const FVector2D VelocityMultiplierRange { 0.f, 1.0f };
 	FVector Velocity = GetVelocity();
@@ -336,99 +369,102 @@ void AShooterCharacter::CalculateCrosshairFiringFactor(const float DeltaTime, fl
 
 void AShooterCharacter::TraceForItems()
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_TraceForItems);
+
 	if (bShouldTraceForItems)
 	{
-		FHitResult ItemTraceResult;
-		TraceUnderCrosshairs(ItemTraceResult);
-		if (ItemTraceResult.bBlockingHit)
+		FVector CrosshairWorldPosition;
+		FVector CrosshairWorldDirection;
+		if (GetScreenSpaceLocationOfCrosshairs(CrosshairWorldPosition, CrosshairWorldDirection))
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.Actor);
-
-			const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
-			if (TraceHitWeapon)
-			{
-				if (HighlightedSlot == -1)
-				{
-					// Not currently highlighting a slot; highlight one
-					HighlightInventorySlot();
-				}
-			}
-			else
-			{
-				// Is a slot being highlighted?
-				if (HighlightedSlot != -1)
-				{
-					// UnHighlight the slot
-					UnHighlightInventorySlot();
-				}
-			}
-			
-			if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterping)
-			{
-				TraceHitItem = nullptr;
-			}
-
-			if (TraceHitItem && TraceHitItem->GetPickUpWidget())
-			{
-				TraceHitItem->GetPickUpWidget()->SetVisibility(true);
-				TraceHitItem->CustomDepthEnabled(true);
-
-				if (Inventory.Num() >= INVENTORY_CAPACITY)
-				{
-					// Inventory is full
-					TraceHitItem->SetCharacterInventoryFull(true);
-				}
-				else
-				{
-					// Inventory has room
-					TraceHitItem->SetCharacterInventoryFull(false);
-				}
-			}
-
-			// We hit an AItem last frame
-			if (TraceHitItemLastFrame)
-			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					// We are hitting a different AItem this frame from last frame
-					// Or AItem is null this frame
-					TraceHitItemLastFrame->GetPickUpWidget()->SetVisibility(false);
-					TraceHitItemLastFrame->CustomDepthEnabled(false);
-				}
-			}
-
-			// Store a reference to HitItem for next frame
-			TraceHitItemLastFrame = TraceHitItem;
+			// Result is delivered next frame to OnItemTraceCompleted
+			const FVector Start{ CrosshairWorldPosition };
+			const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
+			const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ItemTrace));
+			ItemTraceHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECollisionChannel::ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &ItemTraceDelegate);
+			UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_TraceIssued);
 		}
 	}
 	else if (TraceHitItemLastFrame)
 	{
 		// No longer overlapping any items,
 		// Item last frame should not show widget
-		TraceHitItemLastFrame->GetPickUpWidget()->SetVisibility(false);
-		TraceHitItemLastFrame->CustomDepthEnabled(false);
+		UpdateTraceHitItem(nullptr);
 	}
 }
 
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult)
+void AShooterCharacter::OnItemTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
 {
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
+	// Stopped overlapping items while the trace was in flight
+	if (!bShouldTraceForItems || TraceHandle != ItemTraceHandle)
+	{
+		return;
+	}
 
-	const bool bScreenToWorld = GetScreenSpaceLocationOfCrosshairs(CrosshairWorldPosition, CrosshairWorldDirection);
-	if (bScreenToWorld)
+	AItem* HitItem = nullptr;
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
 	{
-		const FVector Start { CrosshairWorldPosition };
-		const FVector End {  Start + CrosshairWorldDirection * 50000.f };
-		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
+		HitItem = Cast<AItem>(TraceDatum.OutHits[0].Actor.Get());
+	}
+
+	UpdateTraceHitItem(HitItem);
+}
 
-		if (OutHitResult.bBlockingHit)
+void AShooterCharacter::UpdateTraceHitItem(AItem* HitItem)
+{
+	const auto TraceHitWeapon = Cast<AWeapon>(HitItem);
+	if (TraceHitWeapon)
+	{
+		if (HighlightedSlot == -1)
 		{
-			return true;
+			// Not currently highlighting a slot; highlight one
+			HighlightInventorySlot();
 		}
 	}
-	
-	return false;
+	else
+	{
+		// Is a slot being highlighted?
+		if (HighlightedSlot != -1)
+		{
+			// UnHighlight the slot
+			UnHighlightInventorySlot();
+		}
+	}
+
+	if (HitItem && HitItem->GetItemState() == EItemState::EIS_EquipInterping)
+	{
+		HitItem = nullptr;
+	}
+
+	TraceHitItem = HitItem;
+	if (TraceHitItem)
+	{
+		// Inventory can fill up while looking at the same item
+		TraceHitItem->SetCharacterInventoryFull(Inventory.Num() >= INVENTORY_CAPACITY);
+	}
+
+	if (TraceHitItem == TraceHitItemLastFrame)
+	{
+		// Same item as last frame; widget and custom depth are already set
+		return;
+	}
+
+	// We are hitting a different AItem this frame from last frame
+	// Or AItem is null this frame
+	if (TraceHitItemLastFrame && TraceHitItemLastFrame->GetPickUpWidget())
+	{
+		TraceHitItemLastFrame->GetPickUpWidget()->SetVisibility(false);
+		TraceHitItemLastFrame->CustomDepthEnabled(false);
+	}
+
+	if (TraceHitItem && TraceHitItem->GetPickUpWidget())
+	{
+		TraceHitItem->GetPickUpWidget()->SetVisibility(true);
+		TraceHitItem->CustomDepthEnabled(true);
+	}
+
+	// Store a reference to HitItem for next frame
+	TraceHitItemLastFrame = TraceHitItem;
 }
 
 void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -571,7 +607,12 @@ void AShooterCharacter::FireButtonReleased()
 	bFireButtonPressed = false;
 }
 
-void AShooterCharacter::FireWeapon()
+void AShooterCharacter::SetFireButtonPressed(const bool bPressed)
+{
+	bPressed ? FireButtonPressed() : FireButtonReleased();
+}
+
+void AShooterCharacter::FireWeapon(const float FrameAlpha)
 {
 	if (EquippedWeapon == nullptr)
 	{
@@ -587,7 +628,7 @@ void AShooterCharacter::FireWeapon()
 	{
 	
 		PlayFireSoundCue();
-		SendBullet();
+		SendBullet(FrameAlpha);
 		PlayFireAnimMontage();
 		EquippedWeapon->DecrementAmmo();
 
@@ -610,121 +651,170 @@ void AShooterCharacter::PlayFireSoundCue() const
 	}
 }
 
-void AShooterCharacter::SendBullet()
+void AShooterCharacter::SendBullet(const float FrameAlpha)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_SendBullet);
+	INC_DWORD_STAT(STAT_ShotsFired);
+	UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_ShotFired);
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT
+	{
+		SendBulletSeconds += FPlatformTime::Seconds() - StartSeconds;
+		++BulletsSent;
+	};
+
 	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
 	if (BarrelSocket)
 	{
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+		FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+
+		// Get world position and direction of crosshairs
+		FVector CrosshairWorldPosition;
+		FVector CrosshairWorldDirection;
+		const bool bCrosshairsValid = GetScreenSpaceLocationOfCrosshairs(CrosshairWorldPosition, CrosshairWorldDirection);
+
+		// Shots due earlier in the frame leave from where the weapon was at that time
+		if (FrameAlpha < 1.f && PreviousAimFrame + 1 == GFrameCounter)
+		{
+			INC_DWORD_STAT(STAT_SubFrameShots);
+
+			FTransform BlendedTransform;
+			BlendedTransform.Blend(PreviousMuzzleTransform, SocketTransform, FrameAlpha);
+			SocketTransform = BlendedTransform;
+			CrosshairWorldPosition = FMath::Lerp(PreviousCrosshairPosition, CrosshairWorldPosition, FrameAlpha);
+			CrosshairWorldDirection = FMath::Lerp(PreviousCrosshairDirection, CrosshairWorldDirection, FrameAlpha).GetSafeNormal();
+		}
+
+		UEffectPoolSubsystem* const EffectPoolSubsystem = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
 		UParticleSystem* MuzzleFlash = EquippedWeapon->GetMuzzleFlash();
-		if (MuzzleFlash)
+		if (MuzzleFlash && EffectPoolSubsystem)
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);;
+			EffectPoolSubsystem->SpawnEffect(MuzzleFlash, SocketTransform);
 		}
 
-		FHitResult BeamHitResult;
-		const bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamHitResult);
-		if (bBeamEnd)
+		if (!bCrosshairsValid)
 		{
-			// Does hit Actor implement BulletHitInterface?
-			if (BeamHitResult.Actor.IsValid())
+			return;
+		}
+
+		// Ballistic bullets fly with every other bullet in flight, aimed to cross the crosshairs at the zeroing distance
+		UProjectileSubsystem* const ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+		if (ProjectileSubsystem && EquippedWeapon->GetFireMode() == EFireMode::EFM_Ballistic)
+		{
+			const FVector MuzzleLocation{ SocketTransform.GetLocation() };
+			const FVector AimPoint{ CrosshairWorldPosition + CrosshairWorldDirection * ProjectileSubsystem->GetZeroingDistance() };
+			const FVector MuzzleVelocity{ (AimPoint - MuzzleLocation).GetSafeNormal() * EquippedWeapon->GetMuzzleVelocity() };
+			ProjectileSubsystem->FireProjectile(this, EquippedWeapon, MuzzleLocation, MuzzleVelocity, EquippedWeapon->GetProjectileGravityScale());
+			return;
+		}
+
+		// Traces are resolved in a batch with every other shot fired this frame
+		UHitscanSubsystem* const HitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+		AShotgun* const Shotgun = Cast<AShotgun>(EquippedWeapon);
+		if (HitscanSubsystem && Shotgun)
+		{
+			// Every pellet is queued in one blast, so hits on the same enemy are applied together
+			TArray<FVector, TInlineAllocator<16>> PelletTraceEnds;
+			PelletTraceEnds.SetNumUninitialized(Shotgun->GetPelletCount());
+			Shotgun->GeneratePelletDirections(CrosshairWorldDirection, PelletTraceEnds);
+			for (FVector& PelletTraceEnd : PelletTraceEnds)
 			{
-				IBulletHitInterface* const BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.Actor.Get());
-				if (BulletHitInterface)
+				PelletTraceEnd = CrosshairWorldPosition + PelletTraceEnd * 50'000.f;
+			}
+			HitscanSubsystem->QueueBlast(this, CrosshairWorldPosition, PelletTraceEnds, SocketTransform);
+		}
+		else if (HitscanSubsystem)
+		{
+			const FVector CrosshairTraceEnd{ CrosshairWorldPosition + CrosshairWorldDirection * 50'000.f };
+			HitscanSubsystem->QueueShot(this, CrosshairWorldPosition, CrosshairTraceEnd, SocketTransform);
+		}
+	}
+}
+
+void AShooterCharacter::ApplyHitscanShots(TArrayView<const FHitscanShot> Shots, const AWeapon* Weapon)
+{
+	UEffectPoolSubsystem* const EffectPoolSubsystem = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	const AWeapon* const FiredWeapon = Weapon ? Weapon : EquippedWeapon;
+
+	/** Summed damage of the shots to one enemy. */
+	struct FEnemyHit
+	{
+		AEnemy* Enemy;
+		float Damage;
+		FVector Location;
+		bool bHeadShot;
+	};
+	TArray<FEnemyHit, TInlineAllocator<8>> EnemyHits;
+	TArray<AActor*, TInlineAllocator<8>> NotifiedActors;
+
+	const auto SpawnBeam = [this, EffectPoolSubsystem](const FTransform& SourceTransform, const FVector& Target)
+	{
+		UParticleSystemComponent* Beam = EffectPoolSubsystem ? EffectPoolSubsystem->SpawnEffect(BeamParticles, SourceTransform) : nullptr;
+		if (Beam)
+		{
+			Beam->SetVectorParameter(FName("Target"), Target);
+		}
+	};
+
+	for (const FHitscanShot& Shot : Shots)
+	{
+		for (const FHitscanImpact& Impact : Shot.Impacts)
+		{
+			const FHitResult& BeamHitResult = Impact.HitResult;
+			AActor* const HitActor = BeamHitResult.Actor.Get();
+			if (HitActor)
+			{
+				// Does hit Actor implement BulletHitInterface? Pellets hitting the same actor notify it once
+				IBulletHitInterface* const BulletHitInterface = Cast<IBulletHitInterface>(HitActor);
+				if (BulletHitInterface && !NotifiedActors.Contains(HitActor))
 				{
+					NotifiedActors.Add(HitActor);
 					BulletHitInterface->BulletHit_Implementation(BeamHitResult, this, GetController());
 				}
 
-				AEnemy* const HitEnemy = Cast<AEnemy>(BeamHitResult.Actor.Get());
-				if (HitEnemy)
+				// Bullets that went through something deal the damage of the power they had left
+				AEnemy* const HitEnemy = Cast<AEnemy>(HitActor);
+				if (HitEnemy && FiredWeapon)
 				{
-					int32 Damage;
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone())
-					{
-						// Head shot
-						Damage = EquippedWeapon->GetHeadShotDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage, GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, true);
-					}
-					else
+					const EHitZone HitZone = HitEnemy->GetHitZone(BeamHitResult);
+					FEnemyHit* EnemyHit = EnemyHits.FindByPredicate([HitEnemy](const FEnemyHit& Hit) { return Hit.Enemy == HitEnemy; });
+					if (EnemyHit == nullptr)
 					{
-						// Body shot
-						Damage = EquippedWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage, GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, false);
-
+						EnemyHit = &EnemyHits.Add_GetRef({ HitEnemy, 0.f, BeamHitResult.Location, false });
 					}
+					EnemyHit->Damage += FiredWeapon->GetZoneDamage(HitZone) * Impact.Power;
+					EnemyHit->bHeadShot |= HitZone == EHitZone::EHZ_Head;
 				}
 			}
 			else
 			{
 				// Spawn default particles
-				if (ImpactParticle)
+				if (ImpactParticle && EffectPoolSubsystem)
 				{
-					UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, BeamHitResult.Location);
+					EffectPoolSubsystem->SpawnEffectAtLocation(ImpactParticle, BeamHitResult.Location);
 				}
 			}
 
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
-			if (Beam)
-			{
-				Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
-			}
+			SpawnBeam(FTransform(Shot.MuzzleTransform.GetRotation(), Impact.SegmentStart), BeamHitResult.Location);
 		}
-	}
-}
 
-bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult)
-{
-	FVector OutBeamLocation;
-	// Check for crosshair trace hit
-	FHitResult CrosshairHitResult;
-	bool bCrosshairHit = TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation);
-
-	if (bCrosshairHit)
-	{
-		// Tentative beam location - still need to trace from gun
-		OutBeamLocation = CrosshairHitResult.Location;
-	}
-	
-	// Perform a second trace, this time from the gun barrel
-	const FVector WeaponTraceStart{ MuzzleSocketLocation };
-	const FVector StartToEnd{ OutBeamLocation - WeaponTraceStart };
-	const FVector WeaponTraceEnd{ MuzzleSocketLocation + StartToEnd * 1.25f };
-	GetWorld()->LineTraceSingleByChannel(OutHitResult, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
-
-	// object between barrel and BeamEndPoint?
-	if (!OutHitResult.bBlockingHit) 
-	{
-		OutHitResult.Location = OutBeamLocation;
-		return false;
+		if (!Shot.bStopped)
+		{
+			SpawnBeam(FTransform(Shot.MuzzleTransform.GetRotation(), Shot.TailStart), Shot.TailEnd);
+		}
 	}
 
-	return true;
-}
-
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
-{
-	// Get world position and direction of crosshairs
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
-	const bool bScreenToWorld = GetScreenSpaceLocationOfCrosshairs(CrosshairWorldPosition, CrosshairWorldDirection);
-	if (bScreenToWorld)
+	// One damage event and one hit number per enemy, however many pellets hit it
+	for (const FEnemyHit& EnemyHit : EnemyHits)
 	{
-		// Trace from Crosshair world location outward
-		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
-		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
-
-		if (OutHitResult.bBlockingHit)
+		if (IsValid(EnemyHit.Enemy))
 		{
-			OutHitLocation = OutHitResult.Location;
-			return true;
+			const int32 Damage = static_cast<int32>(EnemyHit.Damage);
+			UGameplayStatics::ApplyDamage(EnemyHit.Enemy, Damage, GetController(), this, UDamageType::StaticClass());
+			EnemyHit.Enemy->SpawnHitNumber(Damage, EnemyHit.Location, EnemyHit.bHeadShot);
 		}
 	}
-
-	return false;
 }
 
 bool AShooterCharacter::GetScreenSpaceLocationOfCrosshairs(FVector& CrosshairWorldPosition, FVector& CrosshairWorldDirection)
@@ -775,11 +865,18 @@ void AShooterCharacter::StartFireTimer()
 		return;
 	}
 	
+	// Only time overdue from the last shot carries over, a leftover wait does not
 	CombatState = ECombatState::ECS_FireTimerInProgress;
-	GetWorldTimerManager().SetTimer(AutoFireTimer, this, &AShooterCharacter::AutoFireReset, EquippedWeapon->GetAutoFireRate());
+	AutoFireCooldown = FMath::Min(AutoFireCooldown, 0.f) + EquippedWeapon->GetAutoFireRate();
+
+	// Input runs before the tick, so a press must not count the time of the frame it happened in
+	if (!bUpdatingAutoFire)
+	{
+		AutoFireArmedFrame = GFrameCounter;
+	}
 }
 
-void AShooterCharacter::AutoFireReset()
+void AShooterCharacter::AutoFireReset(const float FrameAlpha)
 {
 	if (CombatState == ECombatState::ECS_Stunned)
 	{
@@ -791,13 +888,63 @@ void AShooterCharacter::AutoFireReset()
 	{
 		if (bFireButtonPressed && EquippedWeapon->GetAutomatic())
 		{
-			FireWeapon();
+			FireWeapon(FrameAlpha);
 		}
 	}
 	else
 	{
 		ReloadWeapon();
 	}
+
+	// The burst ended, the next press fires right away
+	if (CombatState != ECombatState::ECS_FireTimerInProgress)
+	{
+		AutoFireCooldown = 0.f;
+	}
+}
+
+void AShooterCharacter::UpdateAutoFire(const float DeltaTime)
+{
+	if (CombatState != ECombatState::ECS_FireTimerInProgress)
+	{
+		return;
+	}
+
+	if (AutoFireArmedFrame == GFrameCounter)
+	{
+		RecordFireAim();
+		return;
+	}
+
+	TGuardValue<bool> UpdatingAutoFireGuard(bUpdatingAutoFire, true);
+	AutoFireCooldown -= DeltaTime;
+	for (int32 ShotIndex = 0; ShotIndex < ShooterCharacter::MaxAutoFireShotsPerFrame && AutoFireCooldown <= 0.f; ++ShotIndex)
+	{
+		// The shot was due AutoFireCooldown seconds before this tick
+		const float FrameAlpha = DeltaTime > 0.f ? FMath::Clamp(1.f + AutoFireCooldown / DeltaTime, 0.f, 1.f) : 1.f;
+		AutoFireReset(FrameAlpha);
+		if (CombatState != ECombatState::ECS_FireTimerInProgress)
+		{
+			break;
+		}
+	}
+
+	if (CombatState == ECombatState::ECS_FireTimerInProgress)
+	{
+		// Shots left over by the per frame bound are dropped rather than fired in a burst later
+		AutoFireCooldown = FMath::Max(AutoFireCooldown, 0.f);
+		RecordFireAim();
+	}
+}
+
+void AShooterCharacter::RecordFireAim()
+{
+	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon ? EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket") : nullptr;
+	if (BarrelSocket && GetScreenSpaceLocationOfCrosshairs(PreviousCrosshairPosition, PreviousCrosshairDirection))
+	{
+		PreviousMuzzleTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+		PreviousAimFrame = GFrameCounter;
+	}
 }
 
 void AShooterCharacter::AimingButtonPressed()
@@ -1207,7 +1354,16 @@ void AShooterCharacter::PickUpAmmo(AAmmo* Ammo)
 		}
 	}
 
-	Ammo->Destroy();
+	// Ammo pickups are recycled for the next loot drop
+	UPickupPoolSubsystem* const PickupPoolSubsystem = GetWorld()->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPoolSubsystem)
+	{
+		PickupPoolSubsystem->ReleaseItem(Ammo);
+	}
+	else
+	{
+		Ammo->Destroy();
+	}
 }
 
 void AShooterCharacter::GrabClip()
@@ -1327,6 +1483,9 @@ void AShooterCharacter::EndStun()
 
 float AShooterCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterCharacterTakeDamage);
+	UTelemetrySubsystem::Record(GetWorld(), ETelemetryEvent::ETE_DamageEvent, DamageAmount);
+
 	Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 
 	if (Health - DamageAmount <= 0.f)
@@ -3,7 +3,8 @@
 #include "Shooter/Public/Player/ShooterPlayerController.h"
 #include "Blueprint/UserWidget.h"
 
-AShooterPlayerController::AShooterPlayerController()
+AShooterPlayerController::AShooterPlayerController() :
+	HUDOverlay(nullptr)
 {
 	
 }
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/UI/HitNumberManager.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "SceneView.h"
+#include "Shooter/Shooter.h"
+#include "UI/HitNumberWidget.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Numbers Shown"), STAT_HitNumbersShown, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Numbers Recycled Early"), STAT_HitNumbersRecycledEarly, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hit Number Widgets"), STAT_HitNumberWidgets, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Hit Number Update"), STAT_HitNumberUpdate, STATGROUP_Shooter);
+
+UHitNumberManager::UHitNumberManager() :
+	PlayerController(nullptr),
+	Head(0),
+	ActiveCount(0),
+	DisplayTime(1.5f)
+{
+
+}
+
+void UHitNumberManager::Initialize(APlayerController* InPlayerController, const TSubclassOf<UHitNumberWidget> InWidgetClass, const int32 MaxHitNumbers, const float InDisplayTime)
+{
+	PlayerController = InPlayerController;
+	WidgetClass = InWidgetClass;
+	DisplayTime = InDisplayTime;
+
+	Slots.SetNum(FMath::Max(MaxHitNumbers, 1));
+	Head = 0;
+	ActiveCount = 0;
+}
+
+void UHitNumberManager::ShowHitNumber(const int32 Damage, const FVector& Location, const bool bHeadShot)
+{
+	if (PlayerController == nullptr || WidgetClass == nullptr || Slots.Num() == 0)
+	{
+		return;
+	}
+
+	int32 SlotIndex;
+	if (ActiveCount < Slots.Num())
+	{
+		SlotIndex = (Head + ActiveCount) % Slots.Num();
+		++ActiveCount;
+	}
+	else
+	{
+		// Buffer is full, take over the oldest hit number
+		SlotIndex = Head;
+		Head = (Head + 1) % Slots.Num();
+		INC_DWORD_STAT(STAT_HitNumbersRecycledEarly);
+	}
+
+	FHitNumberSlot& Slot = Slots[SlotIndex];
+	UHitNumberWidget* Widget = GetOrCreateWidget(Slot);
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	Slot.Location = Location;
+	Slot.ExpireTime = PlayerController->GetWorld()->GetTimeSeconds() + DisplayTime;
+
+	// Positioned by the HUD later this frame, before the widget is painted
+	Widget->SetHitNumber(Damage, bHeadShot);
+	Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+
+	INC_DWORD_STAT(STAT_HitNumbersShown);
+}
+
+void UHitNumberManager::AddBlueprintHitNumber(UUserWidget* Widget, const FVector& Location)
+{
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	if (PlayerController == nullptr)
+	{
+		Widget->RemoveFromParent();
+		return;
+	}
+
+	FBlueprintHitNumber& HitNumber = BlueprintHitNumbers.AddDefaulted_GetRef();
+	HitNumber.Widget = Widget;
+	HitNumber.Location = Location;
+	HitNumber.ExpireTime = PlayerController->GetWorld()->GetTimeSeconds() + DisplayTime;
+
+	INC_DWORD_STAT(STAT_HitNumbersShown);
+}
+
+void UHitNumberManager::UpdateHitNumbers(const FMatrix& ViewProjectionMatrix, const FIntRect& ViewRect)
+{
+	if (PlayerController == nullptr || !HasActiveHitNumbers())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_HitNumberUpdate);
+
+	const float TimeSeconds = PlayerController->GetWorld()->GetTimeSeconds();
+	while (ActiveCount > 0 && Slots[Head].ExpireTime <= TimeSeconds)
+	{
+		if (Slots[Head].Widget)
+		{
+			Slots[Head].Widget->SetVisibility(ESlateVisibility::Collapsed);
+		}
+		Head = (Head + 1) % Slots.Num();
+		--ActiveCount;
+	}
+
+	for (int32 Offset = 0; Offset < ActiveCount; ++Offset)
+	{
+		const FHitNumberSlot& Slot = Slots[(Head + Offset) % Slots.Num()];
+		FVector2D ScreenPosition;
+		if (Slot.Widget && FSceneView::ProjectWorldToScreen(Slot.Location, ViewRect, ViewProjectionMatrix, ScreenPosition))
+		{
+			Slot.Widget->SetPositionInViewport(ScreenPosition);
+		}
+	}
+
+	// Same display time for all of them, so the expired ones are at the front
+	int32 NumExpired = 0;
+	while (NumExpired < BlueprintHitNumbers.Num() && BlueprintHitNumbers[NumExpired].ExpireTime <= TimeSeconds)
+	{
+		if (BlueprintHitNumbers[NumExpired].Widget)
+		{
+			BlueprintHitNumbers[NumExpired].Widget->RemoveFromParent();
+		}
+		++NumExpired;
+	}
+	BlueprintHitNumbers.RemoveAt(0, NumExpired, false);
+
+	for (const FBlueprintHitNumber& HitNumber : BlueprintHitNumbers)
+	{
+		FVector2D ScreenPosition;
+		if (HitNumber.Widget && FSceneView::ProjectWorldToScreen(HitNumber.Location, ViewRect, ViewProjectionMatrix, ScreenPosition))
+		{
+			HitNumber.Widget->SetPositionInViewport(ScreenPosition);
+		}
+	}
+}
+
+UHitNumberWidget* UHitNumberManager::GetOrCreateWidget(FHitNumberSlot& Slot) const
+{
+	if (Slot.Widget == nullptr)
+	{
+		Slot.Widget = CreateWidget<UHitNumberWidget>(PlayerController, WidgetClass);
+		if (Slot.Widget)
+		{
+			Slot.Widget->AddToViewport();
+			INC_DWORD_STAT(STAT_HitNumberWidgets);
+		}
+	}
+	return Slot.Widget;
+}
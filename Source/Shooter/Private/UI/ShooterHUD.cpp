@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Shooter/Public/UI/ShooterHUD.h"
+
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "SceneView.h"
+#include "Shooter/Shooter.h"
+#include "UI/HitNumberManager.h"
+#include "UI/HitNumberWidget.h"
+
+AShooterHUD::AShooterHUD() :
+	MaxHitNumbers(32),
+	HitNumberDisplayTime(1.5f),
+	HitNumberManager(nullptr)
+{
+	
+}
+
+void AShooterHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const TSubclassOf<UHitNumberWidget> WidgetClass = HitNumberWidgetClass.LoadSynchronous();
+	if (WidgetClass == nullptr && !HitNumberWidgetClass.IsNull())
+	{
+		UE_LOG(LogShooter, Warning, TEXT("HitNumberWidgetClass %s is not a UHitNumberWidget, enemy blueprints create the hit numbers instead"), *HitNumberWidgetClass.ToString());
+	}
+
+	HitNumberManager = NewObject<UHitNumberManager>(this);
+	HitNumberManager->Initialize(PlayerOwner, WidgetClass, MaxHitNumbers, HitNumberDisplayTime);
+}
+
+void AShooterHUD::DrawHUD()
+{
+	Super::DrawHUD();
+
+	if (HitNumberManager == nullptr || !HitNumberManager->HasActiveHitNumbers())
+	{
+		return;
+	}
+
+	const ULocalPlayer* LocalPlayer = PlayerOwner ? PlayerOwner->GetLocalPlayer() : nullptr;
+	if (LocalPlayer == nullptr || LocalPlayer->ViewportClient == nullptr)
+	{
+		return;
+	}
+
+	// Build the view projection once and share it between all hit numbers
+	FSceneViewProjectionData ProjectionData;
+	if (LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData))
+	{
+		HitNumberManager->UpdateHitNumbers(ProjectionData.ComputeViewProjectionMatrix(), ProjectionData.GetConstrainedViewRect());
+	}
+}
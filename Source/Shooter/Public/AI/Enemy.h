@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Interfaces/BulletHitInterface.h"
+#include "Shooter/Library/HitZoneEnumLibrary.h"
 #include "Enemy.generated.h"
 
 class USoundCue;
@@ -13,6 +14,12 @@ class AEnemyAIController;
 class USphereComponent;
 class UBoxComponent;
 class AShooterCharacter;
+class UDamageAccumulatorComponent;
+class UHitNumberManager;
+class UUserWidget;
+struct FAccumulatedDamage;
+struct FHitZoneTable;
+struct FAnimUpdateRateParameters;
 
 UCLASS()
 class SHOOTER_API AEnemy : public ACharacter, public IBulletHitInterface
@@ -23,18 +30,30 @@ public:
 	// Sets default values for this character's properties
 	AEnemy();
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	virtual void BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController) override;
 
 	virtual float TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
 	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
 
+	/** Returns the zone of the body hit, from the hit zone table shared by the enemies of this class. */
+	EHitZone GetHitZone(const FHitResult& HitResult) const;
+
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
 
-	/** Display amount of damage applied to. */
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetMaxHealth() const { return MaxHealth; }
+	FORCEINLINE void SetHealth(const float NewHealth) { Health = FMath::Clamp(NewHealth, 0.f, MaxHealth); }
+	FORCEINLINE bool IsDying() const { return bDying; }
+
+	/**
+	 * Display amount of damage applied to, using the hit number pool of the local player HUD.
+	 * While damage is accumulated, the hit numbers of a frame are merged into one unless the accumulator keeps them per hit.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void SpawnHitNumber(const int32 Damage, const FVector HitLocation, bool bHeadShot);
+
+	/** Create the hit number widget in blueprint; only called when the HUD has no pooled hit number widget class. */
 	UFUNCTION(BlueprintImplementableEvent)
 	void ShowHitNumber(const int32 Damage, const FVector HitLocation, bool bHeadShot);
 	
@@ -125,22 +144,6 @@ protected:
 	
 	void ResetHitReactTimer();
 
-	/** Store Widget/Location in HitNumbers map when hit applied.
-	* @param HitNumber display widget reference.
-	* @param Location widget location.
-	*/
-	UFUNCTION(BlueprintCallable)
-	void StoreHitNumber(UUserWidget* HitNumber, FVector Location);
-
-	/** Remove HitNumber from HitNumbers Map and ViewPort after specific time.
-	 * @param HitNumber to be removed. 
-	 */
-	UFUNCTION()
-	void DestroyHitNumber(UUserWidget* HitNumber);
-	
-	/** Update HitNumbers screen space location according to the hit location of the bullet. */
-	void UpdateHitNumbers() const;
-
 	UFUNCTION(BlueprintCallable)
 	void SetStunned(const bool Stunned);
 
@@ -154,6 +157,29 @@ protected:
 
 	UFUNCTION(BlueprintPure)
 	FName GetAttackSectionName() const;
+
+	/** Set the update rate optimization bands of the mesh once its parameters are created. */
+	void SetupAnimUpdateRateParams(FAnimUpdateRateParameters* Params) const;
+
+	/** Blackboard target, health, health bar and stun for damage taken; runs once per hit or once per frame when accumulated. */
+	void ApplyDamageTaken(const float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser);
+
+	/** Apply the hits the damage accumulator collected during the frame. */
+	void ResolveAccumulatedDamage(const FAccumulatedDamage& AccumulatedDamage);
+
+	/**
+	 * Hand a widget created by ShowHitNumber to the HUD, which places it at the hit location and removes it after its display time.
+	 * @param HitNumber display widget reference.
+	 * @param Location widget location.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void StoreHitNumber(UUserWidget* HitNumber, FVector Location);
+
+	/** Show a hit number right away. */
+	void DisplayHitNumber(const int32 Damage, const FVector& HitLocation, const bool bHeadShot);
+
+	/** Hit number pool of the local player HUD. */
+	UHitNumberManager* GetHitNumberManager() const;
 	
 private:
 	/** Particles to spawn when hit by bullet. */
@@ -172,10 +198,17 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float MaxHealth;
 
-	/** Name of the head bone. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	/** Name of the head bone. Set on the class only, the hit zone table is shared by all enemies of the class. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	FString HeadBone;
 
+	/** Zone of the listed bones and the bones below them. HeadBone is the head unless listed here. Set on the class only. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	TMap<FName, EHitZone> HitZoneBones;
+
+	/** Built by the first enemy of the class with the same mesh and physics asset, and owned by the data cache. */
+	const FHitZoneTable* HitZoneTable;
+
 	FTimerHandle HealthBarTimer;
 
 	/** Time to display health bar once shot. */
@@ -196,14 +229,6 @@ private:
 	
 	bool bCanHitReact;
 
-	/** Map to store HitNumber widgets and their hit location. */
-	UPROPERTY(VisibleAnywhere, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> HitNumbers;
-
-	/** Time before a HitNumber is removed from the screen. */
-	UPROPERTY(EditAnywhere, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	float HitNumberDestroyTime;
-
 	/** True when playing the get hit animation. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	bool bStunned;
@@ -290,4 +315,23 @@ private:
 	FVector PatrolPoint2;
 	
 	AEnemyAIController* EnemyAIController;
+
+	/** Collects the hits of a frame so they are applied once. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	UDamageAccumulatorComponent* DamageAccumulator;
+
+	/**
+	 * Screen size bands for the animation update rate, largest first.
+	 * The mesh updates every frame above the first band, every second frame above the second and so on.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Animation", meta = (AllowPrivateAccess = "true"))
+	TArray<float> AnimUpdateRateScreenSizes;
+
+	/** Frames between animation updates while the mesh is not rendered. */
+	UPROPERTY(EditAnywhere, Category = "Animation", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 NonRenderedAnimUpdateRate;
+
+	/** Skipped frames are interpolated up to this update rate; slower bands hold the last pose. */
+	UPROPERTY(EditAnywhere, Category = "Animation", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxInterpolatedAnimUpdateRate;
 };
@@ -4,10 +4,30 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "EnemyAnimInstance.generated.h"
 
 class AEnemy;
 
+/**
+ * Proxy of UGruxAnimInstance.
+ * PreUpdate copies the enemy velocity on the game thread and Update computes the animation properties during the parallel animation update.
+ */
+struct FGruxAnimInstanceProxy : public FAnimInstanceProxy
+{
+	explicit FGruxAnimInstanceProxy(UAnimInstance* InAnimInstance);
+
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	FVector Velocity;
+
+	/** False when there is no enemy or the game thread update is used instead. */
+	bool bHasSnapshot;
+};
+
 /**
  * 
  */
@@ -17,14 +37,26 @@ class SHOOTER_API UGruxAnimInstance : public UAnimInstance
 	GENERATED_BODY()
 	
 public:
+	UGruxAnimInstance();
+
+	virtual void NativeInitializeAnimation() override;
+
 	/**
 	 * Updating properties for animation states.
 	 * Called every frame from the animation blueprint from event graph
 	 */
 	UFUNCTION(BlueprintCallable)
 	void UpdateAnimationProperties(const float DeltaTime);
+
+protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 	
 private:
+	friend struct FGruxAnimInstanceProxy;
+
+	/** Update the animation properties from the enemy velocity. Safe to call from a worker thread. */
+	void UpdateFromVelocity(const FVector& Velocity);
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 	AEnemy* Enemy;
 	
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EnemyCrowdManager.generated.h"
+
+class AEnemy;
+class UInstancedStaticMeshComponent;
+
+/** Simulation state of a crowd agent. */
+UENUM()
+enum class ECrowdAgentState : uint8
+{
+	ECAS_Idle UMETA(DisplayName = "Idle"),
+	ECAS_Chasing UMETA(DisplayName = "Chasing"),
+	ECAS_Promoted UMETA(DisplayName = "Promoted"),
+	ECAS_Dead UMETA(DisplayName = "Dead"),
+
+	ECAS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/**
+ * Simulates large numbers of enemies as plain data and renders them as instances of a vertex animated static mesh.
+ * Agents close to the player are promoted to full AEnemy actors and demoted back to data when they get far again.
+ * Agent data is kept as parallel arrays indexed by agent, which is also the instance index in CrowdMeshComponent.
+ */
+UCLASS()
+class SHOOTER_API AEnemyCrowdManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AEnemyCrowdManager();
+
+	virtual void Tick(float DeltaTime) override;
+
+	/**
+	 * Add an agent to the crowd.
+	 * @param Location world location of the agent.
+	 * @return index of the agent.
+	 */
+	int32 AddAgent(const FVector& Location);
+
+	FORCEINLINE int32 GetNumAgents() const { return Positions.Num(); }
+	FORCEINLINE int32 GetNumPromoted() const { return PromotedEnemies.Num(); }
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** Move the agents and build their instance transforms. Runs on worker threads. */
+	void UpdateAgents(const FVector& PlayerLocation, const float DeltaTime);
+
+	/** Swap agents between data and actors around the player. */
+	void UpdatePromotions(const FVector& PlayerLocation);
+
+	/** Spawn the actor for the agent. */
+	bool PromoteAgent(const int32 AgentIndex);
+
+	/** Copy the actor state back to the agent and destroy the actor. */
+	void DemoteAgent(const int32 AgentIndex, AEnemy* Enemy);
+
+	/** Set the vertex animation of the agent instance. */
+	void SetInstanceAnimation(const int32 AgentIndex, const ECrowdAgentState State);
+
+	/** Renders all agents that are not promoted. The material reads the animation from the per instance custom data. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	UInstancedStaticMeshComponent* CrowdMeshComponent;
+
+	/** Enemy spawned when an agent is promoted. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AEnemy> EnemyClass;
+
+	/** Agents spawned around the manager on begin play. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	int32 InitialCrowdSize;
+
+	/** Radius around the manager to spawn the initial agents in. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	float SpawnRadius;
+
+	/** Agents closer than this to the player become AEnemy actors. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	float PromoteRadius;
+
+	/** Promoted enemies further than this from the player go back to the crowd. Larger than PromoteRadius to avoid flickering. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	float DemoteRadius;
+
+	/** Maximum AEnemy actors alive at the same time. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	int32 MaxPromotedEnemies;
+
+	/** Maximum promotions per frame, to spread the cost of spawning. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	int32 MaxPromotionsPerFrame;
+
+	/** Agents closer than this to the player walk towards the player. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	float ChaseRadius;
+
+	/** Walk speed of chasing agents. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crowd", meta = (AllowPrivateAccess = "true"))
+	float MoveSpeed;
+
+	/** Agent positions. */
+	TArray<FVector> Positions;
+
+	/** Agent yaw in degrees. */
+	TArray<float> Yaws;
+
+	/** Agent health, copied to and from the actor on promotion and demotion. */
+	TArray<float> Healths;
+
+	TArray<ECrowdAgentState> States;
+
+	/** Per agent flag set by UpdateAgents when the agent is within PromoteRadius. */
+	TArray<bool> WantsPromotion;
+
+	/** State the instance animation was last set for. */
+	TArray<ECrowdAgentState> InstanceAnimationStates;
+
+	/** Instance transforms built by UpdateAgents. */
+	TArray<FTransform> InstanceTransforms;
+
+	/** Actors of the promoted agents by agent index. */
+	TMap<int32, TWeakObjectPtr<AEnemy>> PromotedEnemies;
+
+	/** Health of a freshly spawned agent, read from EnemyClass. */
+	float DefaultHealth;
+};
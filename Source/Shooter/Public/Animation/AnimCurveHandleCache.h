@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/SmartName.h"
+
+class UAnimInstance;
+
+/**
+ * Curves of an anim instance resolved once against its skeleton, then read by handle.
+ * Reading by handle skips building the curve FName from a string, and curves missing from the skeleton are not looked up at all.
+ * Curves that are on the skeleton are still found by name in the curve map of the anim instance, which belongs to the game thread.
+ */
+class SHOOTER_API FAnimCurveHandleCache
+{
+public:
+	/**
+	 * Resolve a curve on the skeleton of the anim instance. Game thread only, usually from NativeInitializeAnimation.
+	 * @param AnimInstance anim instance the curve is read from.
+	 * @param CurveName name of the curve.
+	 * @return handle to read the curve with.
+	 */
+	int32 Resolve(const UAnimInstance* AnimInstance, const FName CurveName);
+
+	/**
+	 * Read a resolved curve as evaluated last frame. Game thread only, e.g. from the PreUpdate of an anim instance proxy.
+	 * @param AnimInstance anim instance the curve was resolved for.
+	 * @param Handle handle returned by Resolve.
+	 * @param DefaultValue value when the curve is not on the skeleton or not evaluated this frame.
+	 */
+	float GetValue(const UAnimInstance* AnimInstance, const int32 Handle, const float DefaultValue = 0.f) const;
+
+	/** Forget all resolved curves, e.g. when the skeleton changes. */
+	void Reset();
+
+	FORCEINLINE bool IsOnSkeleton(const int32 Handle) const { return CurveUIDs.IsValidIndex(Handle) && CurveUIDs[Handle] != SmartName::MaxUID; }
+
+private:
+	/** Curve names by handle. */
+	TArray<FName> CurveNames;
+
+	/** Skeleton curve UIDs by handle; MaxUID when the skeleton does not have the curve. */
+	TArray<SmartName::UID_Type> CurveUIDs;
+};
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DamageAccumulatorComponent.generated.h"
+
+/** Damage collected by a UDamageAccumulatorComponent during a frame. */
+struct FAccumulatedDamage
+{
+	/** Sum of the damage of all hits. */
+	float Damage = 0.f;
+
+	/** Hits summed into Damage. */
+	int32 Hits = 0;
+
+	/** Instigator and causer of the last hit. */
+	TWeakObjectPtr<AController> EventInstigator;
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	/** Sum of the hit numbers merged into one, 0 when none were added. */
+	int32 HitNumberDamage = 0;
+
+	/** Location of the last merged hit number. */
+	FVector HitNumberLocation = FVector::ZeroVector;
+
+	/** True when any merged hit number was a head shot. */
+	bool bHeadShot = false;
+};
+
+DECLARE_DELEGATE_OneParam(FOnAccumulatedDamageResolved, const FAccumulatedDamage&);
+
+/**
+ * Collects the damage an actor takes during a frame and resolves it once after the actors and tickables of the world
+ * have ticked, so the side effects of taking damage run once per frame no matter how many hits landed.
+ * Hit numbers are merged into one as well unless bKeepPerHitNumbers is set.
+ * Accumulation can be turned off with Shooter.Damage.Accumulate to compare against per hit resolution.
+ */
+UCLASS(ClassGroup = (Combat), meta = (BlueprintSpawnableComponent))
+class SHOOTER_API UDamageAccumulatorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDamageAccumulatorComponent();
+
+	/** Returns true when damage should go through AddDamage rather than be resolved on the spot. */
+	static bool IsAccumulationEnabled();
+
+	/** Add a hit to be resolved at the end of the frame. */
+	void AddDamage(const float DamageAmount, AController* EventInstigator, AActor* DamageCauser);
+
+	/** Merge a hit number into the one shown at the end of the frame. */
+	void AddHitNumber(const int32 Damage, const FVector& Location, const bool bHeadShot);
+
+	FORCEINLINE bool KeepsPerHitNumbers() const { return bKeepPerHitNumbers; }
+
+	/** Called once per frame with the hits collected during it. */
+	FOnAccumulatedDamageResolved OnDamageResolved;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** Resolve the pending damage once the world has finished ticking. */
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Start listening for the end of the frame if not already. */
+	void BindPostActorTick();
+
+	void UnbindPostActorTick();
+
+	/** Show every hit number as it lands instead of one per frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	bool bKeepPerHitNumbers;
+
+	FAccumulatedDamage Pending;
+
+	/** Set while bound to FWorldDelegates::OnWorldPostActorTick, i.e. while anything is pending. */
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ExplosionSchedulerSubsystem.generated.h"
+
+class AExplosive;
+
+/** An explosive waiting to go off. */
+struct FScheduledDetonation
+{
+	TWeakObjectPtr<AExplosive> Explosive;
+
+	/** Actor credited with the damage, the shooter that started the chain. */
+	TWeakObjectPtr<AActor> Shooter;
+
+	TWeakObjectPtr<AController> ShooterController;
+
+	/** Where the particles are spawned. */
+	FVector EffectLocation;
+
+	/** World time in seconds at which the explosive goes off. */
+	float DetonationTime;
+
+	/** Chain the detonation belongs to. */
+	int32 ChainId;
+};
+
+/** State shared by the detonations of one chain reaction. */
+struct FExplosionChain
+{
+	/** Characters damaged by the chain; each is damaged once per chain. */
+	TSet<TWeakObjectPtr<AActor>> DamagedVictims;
+
+	/** Detonations of the chain still queued. The chain is dropped when it reaches zero. */
+	int32 PendingDetonations = 0;
+};
+
+/** Explosion damage to one character, summed over the detonations of a frame. */
+struct FPendingExplosionDamage
+{
+	float Damage = 0.f;
+
+	/** Shooter of the first detonation that hit the character this frame. */
+	TWeakObjectPtr<AActor> Shooter;
+
+	TWeakObjectPtr<AController> ShooterController;
+
+	/** Detonations that hit the character this frame. */
+	int32 Hits = 0;
+};
+
+/**
+ * Detonates explosives with a bounded cost per frame.
+ * Explosives hit by a bullet are queued, go off at the next tick and prime the explosives within their radius
+ * to go off after a short delay. Characters are damaged once per chain, particles go through the UEffectPoolSubsystem
+ * and only a few explode sounds are played per frame. The damage of all detonations of a frame is summed per character
+ * and applied as a single damage event at the end of the tick.
+ * Configured in the [/Script/Shooter.ExplosionSchedulerSubsystem] section of DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UExplosionSchedulerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UExplosionSchedulerSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Start a chain reaction with the explosive, which goes off at the next tick.
+	 * @param Explosive explosive that was hit; ignored if already primed.
+	 * @param Shooter actor credited with the damage of the whole chain.
+	 * @param ShooterController controller credited with the damage of the whole chain.
+	 * @param EffectLocation where to spawn the particles of the first explosion.
+	 */
+	void QueueDetonation(AExplosive* Explosive, AActor* Shooter, AController* ShooterController, const FVector& EffectLocation);
+
+	FORCEINLINE int32 GetNumQueued() const { return Queue.Num(); }
+
+private:
+	/** Prime the explosive and add it to the queue. */
+	void Schedule(AExplosive* Explosive, AActor* Shooter, AController* ShooterController, const FVector& EffectLocation, const float Delay, const int32 ChainId);
+
+	/** Play the effects, add the damage to PendingDamage and chain the explosives around. */
+	void Detonate(const FScheduledDetonation& Detonation);
+
+	/** Apply one damage event per character hit this frame. */
+	void ApplyPendingDamage();
+
+	/** Most detonations processed per frame; the rest wait for the next frames. */
+	UPROPERTY(Config)
+	int32 MaxDetonationsPerFrame;
+
+	/** Most explode sounds started per frame. */
+	UPROPERTY(Config)
+	int32 MaxSoundsPerFrame;
+
+	/** Delay range in seconds before a chained explosive goes off. */
+	UPROPERTY(Config)
+	float MinChainDelay;
+
+	UPROPERTY(Config)
+	float MaxChainDelay;
+
+	/** Detonations as a min heap on DetonationTime. */
+	TArray<FScheduledDetonation> Queue;
+
+	TMap<int32, FExplosionChain> Chains;
+
+	TMap<TWeakObjectPtr<AActor>, FPendingExplosionDamage> PendingDamage;
+
+	int32 NextChainId;
+
+	/** Sounds started during the current tick. */
+	int32 SoundsThisFrame;
+};
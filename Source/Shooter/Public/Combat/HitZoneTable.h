@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Shooter/Library/HitZoneEnumLibrary.h"
+
+class UPhysicsAsset;
+struct FReferenceSkeleton;
+
+/**
+ * Hit zone of every body of a physics asset, built once and looked up per hit without allocating.
+ * Hits are looked up by body index, falling back to the bone name for meshes whose bodies differ from the asset.
+ */
+struct SHOOTER_API FHitZoneTable
+{
+	/**
+	 * Assign a zone to every body of the physics asset. A body takes the zone of the closest listed bone
+	 * up the hierarchy from its own bone, and EHZ_Body when there is none.
+	 * @param ZoneBones zone of the listed bones and the bones below them.
+	 */
+	void Build(const UPhysicsAsset* PhysicsAsset, const FReferenceSkeleton& RefSkeleton, const TMap<FName, EHitZone>& ZoneBones);
+
+	/** Returns the zone of the body that was hit. */
+	EHitZone GetZone(const FHitResult& HitResult) const;
+
+	FORCEINLINE int32 GetNumBodies() const { return BodyZones.Num(); }
+
+private:
+	/** Zone by body index. */
+	TArray<EHitZone> BodyZones;
+
+	/** Bone of each body, to validate body index lookups. */
+	TArray<FName> BodyBoneNames;
+
+	TMap<FName, EHitZone> BoneZones;
+};
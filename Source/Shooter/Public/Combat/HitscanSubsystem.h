@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "HitscanSubsystem.generated.h"
+
+class AShooterCharacter;
+
+/** Power a bullet loses going through a physical surface, by the surface name in the PhysicalSurfaces list of DefaultEngine.ini. */
+USTRUCT()
+struct FSurfacePenetration
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName Surface;
+
+	/** Fraction of the full bullet power lost; 1 or more stops every bullet. */
+	UPROPERTY(EditAnywhere)
+	float PowerLoss = 1.f;
+};
+
+/** Something a bullet hit on its way. */
+struct FHitscanImpact
+{
+	FHitResult HitResult;
+
+	/** Where the segment of the bullet that made the hit started, for the beam. */
+	FVector SegmentStart;
+
+	/** Fraction of the bullet power left when it hit; scales the damage. */
+	float Power = 1.f;
+};
+
+/** A single hitscan shot waiting to be resolved by the UHitscanSubsystem. */
+struct FHitscanShot
+{
+	/** Character that fired the shot. */
+	TWeakObjectPtr<AShooterCharacter> Shooter;
+
+	/** Start of the trace from the crosshairs. */
+	FVector CrosshairStart;
+
+	/** End of the trace from the crosshairs. */
+	FVector CrosshairEnd;
+
+	/** Transform of the weapon barrel socket when the shot was fired. */
+	FTransform MuzzleTransform;
+
+	/** Everything the bullet hit from the barrel on, in order; several when it went through or bounced off something. */
+	TArray<FHitscanImpact, TInlineAllocator<2>> Impacts;
+
+	/** Last segment of the bullet, drawn as a beam when the bullet flew on after its last impact. */
+	FVector TailStart;
+	FVector TailEnd;
+
+	/** True when the bullet stopped at its last impact and has no tail. */
+	bool bStopped = false;
+
+	/** Traces run to resolve the shot. */
+	int32 NumTraces = 0;
+
+	/** Pellets of one shotgun blast share an id and are applied together; INDEX_NONE for single shots. */
+	int32 BlastId = INDEX_NONE;
+};
+
+/**
+ * Collects every hitscan shot fired during a frame, resolves all of their traces as one batch
+ * after physics and then hands the results back to the shooters in a single pass.
+ * The pellets of a blast are handed back together, so the shooter can merge their hits per victim.
+ * Bullets go through pawns and thin surfaces and ricochet off surfaces hit at a grazing angle, losing power each time,
+ * within a budget of MaxRetracesPerShot traces after the first one.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UHitscanSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UHitscanSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Queue a shot to be resolved at the end of this frame.
+	 * @param Shooter character that fired the shot and receives the result.
+	 * @param CrosshairStart world position of the crosshairs.
+	 * @param CrosshairEnd end point of the trace from the crosshairs.
+	 * @param MuzzleTransform transform of the barrel socket.
+	 */
+	void QueueShot(AShooterCharacter* Shooter, const FVector& CrosshairStart, const FVector& CrosshairEnd, const FTransform& MuzzleTransform);
+
+	/**
+	 * Queue the pellets of a blast to be resolved at the end of this frame and applied together.
+	 * @param CrosshairEnds end point of the crosshair trace of every pellet.
+	 */
+	void QueueBlast(AShooterCharacter* Shooter, const FVector& CrosshairStart, TArrayView<const FVector> CrosshairEnds, const FTransform& MuzzleTransform);
+
+	/** Returns the time spent resolving and applying shots since the world started. */
+	FORCEINLINE double GetTickSeconds() const { return TickSeconds; }
+
+private:
+	/** Run the crosshair and barrel traces for a shot, following the bullet through and off what it hits. Safe to call from worker threads. */
+	void ResolveShot(const UWorld* World, FHitscanShot& Shot) const;
+
+	/** Returns the power a bullet loses going through what it hit. */
+	float GetPenetrationPowerLoss(const FHitResult& HitResult) const;
+
+	/** Traces a shot may run after the barrel trace, to find exits and follow penetrations and ricochets. */
+	UPROPERTY(Config)
+	int32 MaxRetracesPerShot;
+
+	/** Surfaces thicker than this, in cm, stop bullets. */
+	UPROPERTY(Config)
+	float MaxPenetrationDepth;
+
+	/** Power lost going through surfaces not listed in SurfacePenetrations. */
+	UPROPERTY(Config)
+	float DefaultPowerLoss;
+
+	UPROPERTY(Config)
+	TArray<FSurfacePenetration> SurfacePenetrations;
+
+	/** Power lost going through a pawn. */
+	UPROPERTY(Config)
+	float PawnPowerLoss;
+
+	/** Bullets hitting a surface at less than this angle in degrees ricochet instead of going through. */
+	UPROPERTY(Config)
+	float RicochetAngle;
+
+	/** Power lost by a ricochet. */
+	UPROPERTY(Config)
+	float RicochetPowerLoss;
+
+	/** Power loss by EPhysicalSurface, built from SurfacePenetrations. */
+	TArray<float> SurfacePowerLosses;
+
+	/** Shots fired this frame. */
+	TArray<FHitscanShot> PendingShots;
+
+	/** Shots being resolved; kept around so the allocation is reused every frame. */
+	TArray<FHitscanShot> ResolvingShots;
+
+	int32 NextBlastId = 0;
+
+	/** Accumulated Tick time, read by the benchmark. */
+	double TickSeconds = 0.0;
+};
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectileSubsystem.generated.h"
+
+class AShooterCharacter;
+class AWeapon;
+
+/**
+ * Flies the bullets of ballistic weapons, with drop and travel time, without an actor per bullet.
+ * Bullets are kept as parallel arrays indexed by bullet. Every frame all of them are integrated and the segments they
+ * travelled are traced against the world as one batch on worker threads, then the hits are handed back to the shooters
+ * on the game thread, which notify IBulletHitInterface actors and apply the zone damage of the weapon.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UProjectileSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UProjectileSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Fire a bullet; it first moves at the end of this frame.
+	 * @param Shooter character that fired the bullet and receives its hit.
+	 * @param Weapon weapon the bullet was fired with, for the damage of the hit.
+	 * @param Location world location of the barrel.
+	 * @param Velocity initial velocity in cm/s.
+	 * @param GravityScale multiplier of the world gravity.
+	 * @return false when MaxProjectiles bullets are already in flight.
+	 */
+	bool FireProjectile(AShooterCharacter* Shooter, AWeapon* Weapon, const FVector& Location, const FVector& Velocity, const float GravityScale);
+
+	FORCEINLINE int32 GetNumProjectiles() const { return Positions.Num(); }
+	FORCEINLINE float GetZeroingDistance() const { return ZeroingDistance; }
+
+	/** Returns the time spent moving bullets and applying their hits since the world started. */
+	FORCEINLINE double GetTickSeconds() const { return TickSeconds; }
+
+private:
+	/** Move the bullet and trace the segment it travelled. Safe to call from worker threads. */
+	void UpdateProjectile(const UWorld* World, const int32 Index, const float DeltaTime, const float GravityZ);
+
+	/** Remove the bullet by swapping the last one into its place. */
+	void RemoveProjectile(const int32 Index);
+
+	/** Bullets in flight at the same time; further bullets are not fired. */
+	UPROPERTY(Config)
+	int32 MaxProjectiles;
+
+	/** Seconds a bullet flies before it is removed without hitting anything. */
+	UPROPERTY(Config)
+	float ProjectileLifetime;
+
+	/** Distance along the crosshairs at which the barrel is aimed, where ballistic bullets cross the crosshairs. */
+	UPROPERTY(Config)
+	float ZeroingDistance;
+
+	/** Bullet positions. */
+	TArray<FVector> Positions;
+
+	/** Bullet velocities. */
+	TArray<FVector> Velocities;
+
+	/** Multiplier of the world gravity per bullet. */
+	TArray<float> GravityScales;
+
+	/** Seconds each bullet has left to fly. */
+	TArray<float> Lifetimes;
+
+	/** Characters that fired the bullets. Only read on the game thread. */
+	TArray<TWeakObjectPtr<AShooterCharacter>> Shooters;
+
+	/** Weapons the bullets were fired with. Only read on the game thread. */
+	TArray<TWeakObjectPtr<AWeapon>> Weapons;
+
+	/** Start of the segment travelled this frame, written by UpdateProjectile. */
+	TArray<FVector> SegmentStarts;
+
+	/** Result of the segment trace, written by UpdateProjectile. */
+	TArray<FHitResult> HitResults;
+
+	/** Per bullet flag set by UpdateProjectile when the segment hit something. */
+	TArray<bool> BlockingHits;
+
+	/** Accumulated Tick time, read by the benchmark. */
+	double TickSeconds;
+};
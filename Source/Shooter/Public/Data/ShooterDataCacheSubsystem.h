@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Combat/HitZoneTable.h"
+#include "Shooter/Library/ItemEnumLibrary.h"
+#include "Shooter/Library/WeaponTypeEnumLibrary.h"
+#include "ShooterDataCacheSubsystem.generated.h"
+
+class UDataTable;
+class UPhysicsAsset;
+class USkeletalMesh;
+struct FItemRarityTable;
+struct FWeaponDataTable;
+
+/**
+ * Loads the weapon and item rarity data tables once per game instance and indexes their rows by
+ * EWeaponType and EItemRarity, so items look up their data without resolving asset paths or row names.
+ * Also keeps the hit zone table of every enemy class, built by the first enemy of the class.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UShooterDataCacheSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterDataCacheSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Cache of the game instance the object belongs to. Construction scripts in the editor have no game instance
+	 * and get a cache shared by all editor worlds instead.
+	 */
+	static const UShooterDataCacheSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Row of the weapon type, nullptr when the table has no row for it. */
+	const FWeaponDataTable* GetWeaponData(const EWeaponType WeaponType) const;
+
+	/** Row of the item rarity, nullptr when the table has no row for it. */
+	const FItemRarityTable* GetItemRarityData(const EItemRarity ItemRarity) const;
+
+	/**
+	 * Hit zone table of the class with the mesh, built on first use. The table lives as long as the cache.
+	 * @param OwnerClass class the table is shared by; the zone bones come from its defaults.
+	 * @param SkeletalMesh mesh the bone hierarchy is read from.
+	 * @param PhysicsAsset physics asset the bodies are read from, which can be overridden per mesh component.
+	 * @param Build fills the table when the combination has none yet.
+	 */
+	const FHitZoneTable& GetHitZoneTable(const UClass* OwnerClass, const USkeletalMesh* SkeletalMesh, const UPhysicsAsset* PhysicsAsset, TFunctionRef<void(FHitZoneTable&)> Build) const;
+
+private:
+	/** Load the tables and index their rows if not done yet. */
+	void LoadTables();
+
+	/** Rebuild the row arrays from the loaded tables. */
+	void BuildRowIndex();
+
+	/** Stop listening to table changes and forget the rows. */
+	void ReleaseTables();
+
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> WeaponDataTablePath;
+
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> ItemRarityDataTablePath;
+
+	UPROPERTY()
+	UDataTable* WeaponDataTable;
+
+	UPROPERTY()
+	UDataTable* ItemRarityDataTable;
+
+	/** Weapon rows indexed by EWeaponType. */
+	TArray<const FWeaponDataTable*> WeaponRows;
+
+	/** Item rarity rows indexed by EItemRarity. */
+	TArray<const FItemRarityTable*> ItemRarityRows;
+
+	/** Class, mesh and physics asset a hit zone table is built for. */
+	using FHitZoneTableKey = TTuple<TWeakObjectPtr<const UClass>, TWeakObjectPtr<const USkeletalMesh>, TWeakObjectPtr<const UPhysicsAsset>>;
+
+	/** Hit zone tables by class, mesh and physics asset; boxed so references stay valid while the map grows. */
+	mutable TMap<FHitZoneTableKey, TUniquePtr<FHitZoneTable>> HitZoneTables;
+};
@@ -10,6 +10,13 @@
 class USoundCue;
 class USphereComponent;
 
+/** Damage an explosion deals to one character, after falloff and occlusion. */
+struct FExplosiveHit
+{
+	AActor* Victim;
+	float Damage;
+};
+
 UCLASS()
 class SHOOTER_API AExplosive : public AActor, public IBulletHitInterface
 {
@@ -19,17 +26,43 @@ public:
 	// Sets default values for this actor's properties
 	AExplosive();
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
+	/** Queue the detonation with the UExplosionSchedulerSubsystem, unless the explosive is already primed. */
 	virtual void BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController) override;
+
+	/**
+	 * Compute the damage to the characters in the radius and destroy the explosive.
+	 * Applying the damage, particles and sound are left to the caller.
+	 * @param DamagedVictims characters already damaged by the chain, skipped here; the victims this explosion deals damage to are added.
+	 * @param OutNearbyExplosives other explosives in the radius that are not primed yet.
+	 * @param OutHits damage to each new victim.
+	 */
+	void Explode(TSet<TWeakObjectPtr<AActor>>& DamagedVictims, TArray<AExplosive*>& OutNearbyExplosives, TArray<FExplosiveHit>& OutHits);
+
+	/** Mark the explosive as queued for detonation, so further hits are ignored. */
+	FORCEINLINE void Prime() { bPrimed = true; }
+
+	FORCEINLINE bool IsPrimed() const { return bPrimed; }
+	FORCEINLINE UParticleSystem* GetExplodeParticles() const { return ExplodeParticles; }
+	FORCEINLINE USoundCue* GetExplodeSound() const { return ExplodeSound; }
 	
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	/** Apply damage to the overlapped actors during explosion. */
-	void ApplyExplosiveDamage(AActor* Shooter, AController* ShooterController) const;
+	/** Find the characters and the other explosives within the overlap sphere with a single query. */
+	void QueryBlastRadius(TArray<AActor*>& OutVictims, TArray<AExplosive*>& OutExplosives) const;
+
+	/**
+	 * Compute the damage to the victims not in DamagedVictims in one pass.
+	 * Damage falls off with the distance to the explosion, and occluded characters take OccludedDamageScale of it.
+	 */
+	void ComputeExplosiveDamage(const TArray<AActor*>& Victims, TSet<TWeakObjectPtr<AActor>>& DamagedVictims, TArray<FExplosiveHit>& OutHits) const;
+
+	/** Returns the damage at the distance from the explosion, before occlusion. */
+	float GetFalloffDamage(const float Distance) const;
+
+	/** Returns true when nothing blocks visibility between the explosion and the victim. */
+	bool HasLineOfSight(const FVector& Origin, const AActor* Victim) const;
 	
 private:
 	/** Particles to spawn when hit by bullet. */
@@ -40,7 +73,10 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	USoundCue* ExplodeSound;
 
-	/** Used to determine what Actors overlapped during explosion. */
+	/**
+	 * Radius of the explosion. Has no collision of its own, so idle explosives cost nothing to moving actors;
+	 * the characters inside are queried once when the explosive goes off.
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	USphereComponent* OverlapSphere;
 
@@ -48,7 +84,26 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* ExplosiveMeshComponent;
 
-	/** Damage amount for explosive. */
+	/** Damage within DamageInnerRadius of the explosion. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float Damage; 
+
+	/** Characters closer than this take the full Damage. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float DamageInnerRadius;
+
+	/** Damage at the radius of the overlap sphere. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float MinimumDamage;
+
+	/** Exponent of the falloff between the inner radius and the sphere radius; 1 is linear. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", ClampMin = "0.01"))
+	float DamageFalloff;
+
+	/** Fraction of Damage applied to characters in the radius but out of line of sight of the explosion. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "1.0"))
+	float OccludedDamageScale;
+
+	/** True once the detonation is queued. */
+	bool bPrimed;
 };
@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Engine/DataTable.h"
 #include "Shooter/Library/AmmoTypeEnumLibrary.h"
+#include "Shooter/Library/FireModeEnumLibrary.h"
+#include "Shooter/Library/HitZoneEnumLibrary.h"
 #include "FWeaponDataTable.generated.h"
 
 class USoundCue;
@@ -90,4 +92,28 @@ struct FWeaponDataTable : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float HeadShotDamage;
+
+	/** Multiplier of Damage per hit zone. Zones not listed deal HeadShotDamage to the head and Damage elsewhere. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TMap<EHitZone, float> ZoneDamageMultipliers;
+
+	/** Pellets per shot of a shotgun; each pellet deals the zone damage. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 PelletCount = 1;
+
+	/** Half angle in degrees of the cone the pellets spread in. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float PelletSpreadAngle = 0.f;
+
+	/** Hitscan bullets hit instantly; ballistic bullets fly with drop and travel time. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EFireMode FireMode = EFireMode::EFM_Hitscan;
+
+	/** Speed of ballistic bullets when they leave the barrel, in cm/s. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MuzzleVelocity = 30000.f;
+
+	/** Multiplier of the world gravity on ballistic bullets. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ProjectileGravityScale = 1.f;
 };
\ No newline at end of file
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameMode/ShooterGameModeBase.h"
+#include "ShooterBenchmarkGameMode.generated.h"
+
+class AEnemy;
+class AExplosive;
+class AItem;
+class AShooterCharacter;
+
+/** Costs recorded for one benchmark frame. */
+struct FShooterBenchmarkFrame
+{
+	float FrameMilliseconds;
+	float GameThreadMilliseconds;
+	/** Time spent in SendBullet, which only queues the shots. */
+	float SendBulletMilliseconds;
+	/** Time the hitscan and projectile subsystems spent resolving and applying the shots. */
+	float ShotResolveMilliseconds;
+	int32 BulletsSent;
+	/** Actors with tick enabled at the end of the frame; throttled actors count even when their tick did not run. */
+	int32 TickEnabledActors;
+	/** Item ticks that actually ran during the frame. */
+	int32 ItemTicks;
+	uint64 UsedPhysicalBytes;
+};
+
+/**
+ * Headless gameplay benchmark.
+ * Spawns enemies, pickups and explosives in front of the player, holds the fire button for a fixed number of frames
+ * and writes the cost of every frame and a summary as CSV files to Saved/Benchmarks.
+ * Example:
+ *	UE4Editor Shooter.uproject DefaultMap?game=Bench -game -nullrhi -unattended -benchmark -fps=60
+ *		-BenchEnemies=50 -BenchItems=100 -BenchExplosives=20 -BenchWarmupFrames=120 -BenchFrames=600 -BenchName=Nightly
+ * With -BenchIdle the fire button is never pressed, to measure the idle cost of the spawned actors, e.g.
+ *	-BenchEnemies=0 -BenchItems=0 -BenchExplosives=200 -BenchIdle -BenchName=IdleExplosives
+ * The game exits when the run is done if -unattended or -BenchExit is passed.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API AShooterBenchmarkGameMode : public AShooterGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	AShooterBenchmarkGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** Read the -Bench* arguments. */
+	void ParseCommandLine();
+
+	/** Spawn the enemies, pickups and explosives of the run. */
+	void SpawnBenchmarkActors();
+
+	void OnBeginFrame();
+
+	/** Record the frame that just ended and finish the run after the last one. */
+	void OnEndFrame();
+
+	/** Returns the number of actors in the world with tick enabled. */
+	int32 CountTickEnabledActors() const;
+
+	/** Write the recorded frames and the summary. */
+	void WriteResults() const;
+
+	/** Pawn of the benchmark player, a blueprint of AShooterCharacter. */
+	UPROPERTY(Config)
+	TSoftClassPtr<APawn> BenchmarkPawnClass;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<APlayerController> BenchmarkPlayerControllerClass;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AEnemy> EnemyClass;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AItem> ItemClass;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AExplosive> ExplosiveClass;
+
+	/** Distance in front of the player of the first row of enemies and explosives. */
+	UPROPERTY(Config)
+	float SpawnDistance;
+
+	/** Distance between spawned actors. */
+	UPROPERTY(Config)
+	float SpawnSpacing;
+
+	int32 NumEnemies;
+	int32 NumItems;
+	int32 NumExplosives;
+	int32 NumWarmupFrames;
+	int32 NumFrames;
+
+	/** Prefix of the result files. */
+	FString BenchmarkName;
+
+	TWeakObjectPtr<AShooterCharacter> BenchmarkCharacter;
+
+	/** Frames ended since the run started, warmup included. */
+	int32 FrameCount;
+
+	double FrameStartSeconds;
+	double LastFrameStartSeconds;
+
+	/** Bullet counters of the character at the end of the previous frame. */
+	int32 LastBulletsSent;
+	double LastSendBulletSeconds;
+
+	/** Hitscan and projectile subsystem time at the end of the previous frame. */
+	double LastShotResolveSeconds;
+
+	/** Item ticks run at the end of the previous frame. */
+	uint64 LastItemTicks;
+
+	TArray<FShooterBenchmarkFrame> Frames;
+
+	/** False with -BenchIdle. */
+	bool bHoldFire;
+
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EndFrameHandle;
+
+	bool bFinished;
+};
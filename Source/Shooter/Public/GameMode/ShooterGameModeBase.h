@@ -13,5 +13,10 @@ UCLASS()
 class SHOOTER_API AShooterGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	AShooterGameModeBase();
+
+protected:
+	virtual void BeginPlay() override;
 };
@@ -25,6 +25,9 @@ public:
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
 
 	virtual void CustomDepthEnabled(const bool bEnableCustomDepth) const override;
+
+	/** Also re-enables the pickup sphere that was turned off when the ammo was collected. */
+	virtual void OnAcquiredFromPool() override;
 	
 protected:
 	virtual void BeginPlay() override;
@@ -35,6 +35,12 @@ public:
 
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 
+	/** Returns true if the item needs to tick in its current state; the tick throttle asks before turning tick back on. */
+	FORCEINLINE bool WantsTick() const { return ShouldTickInState(ItemState); }
+
+	/** Returns the number of item ticks that ran since the game started, for the benchmark. */
+	static FORCEINLINE uint64 GetTotalTicks() { return TotalTicks; }
+
 	FORCEINLINE USoundCue* GetPickUpSound() const { return PickUpSound; }
 	FORCEINLINE USoundCue* GetEquipSound() const { return EquipSound; }
 	FORCEINLINE void SetPickUpSound(USoundCue* Sound) { PickUpSound = Sound; }
@@ -73,6 +79,12 @@ public:
 	
 	virtual void CustomDepthEnabled(const bool bEnableCustomDepth) const;
 	virtual void GlowMaterialEnabled(const bool bEnableGlowMaterial) const;
+
+	/** Called by UPickupPoolSubsystem when the item is taken out of the pool to be placed as a pickup. */
+	virtual void OnAcquiredFromPool();
+
+	/** Called by UPickupPoolSubsystem when the item is parked in the pool. Hides the item and turns off its collision and tick. */
+	virtual void OnReleasedToPool();
 	
 protected:
 	// Called when the game starts or when spawned
@@ -111,6 +123,21 @@ protected:
 	void ResetPulseTimer();
 	void UpdatePulse() const;
 
+	/** Hand the pulse over to the item material, which evaluates the baked PulseCurve from the start time. */
+	void StartMaterialPulse() const;
+
+	/** Switch the item material between the baked pulse and the CPU driven parameters. */
+	void SetMaterialPulseEnabled(const bool bEnable) const;
+
+	/** Returns true if the pickup pulse is evaluated by the material instead of UpdatePulse. */
+	FORCEINLINE bool UsesMaterialPulse() const { return bUseMaterialPulse && bMaterialSupportsPulse; }
+
+	/** Returns true if the item needs to tick while in State. */
+	virtual bool ShouldTickInState(const EItemState State) const;
+
+	/** Enable or disable tick based on the current ItemState. */
+	void UpdateTickEnabled();
+
 private:
 	/** Skeleton mesh for the item. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
@@ -237,6 +264,19 @@ private:
 
 	UPROPERTY(VisibleAnywhere, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float FresnelReflectFraction;
+
+	/**
+	 * True to let the material evaluate PulseCurve from a baked lookup texture while in the Pickup state, so idle pickups do not tick.
+	 * Only used when the item material has the "Material Pulse" parameters, otherwise UpdatePulse keeps driving the pulse every tick.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	bool bUseMaterialPulse;
+
+	/** True when the item material has the "Material Pulse" parameter. */
+	bool bMaterialSupportsPulse;
+
+	/** Ticks run by all items; items only tick on the game thread. */
+	static uint64 TotalTicks;
 	
 	/** Icon for this item in the inventory. */	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = "true"))
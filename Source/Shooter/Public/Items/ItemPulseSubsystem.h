@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPulseSubsystem.generated.h"
+
+class UCurveVector;
+class UTexture2D;
+
+/**
+ * Bakes item pulse curves into small lookup textures so the item material can evaluate the pulse
+ * on the GPU and idle pickups do not have to tick. Textures are shared by every item using the same curve.
+ */
+UCLASS()
+class SHOOTER_API UItemPulseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Returns the lookup texture for the curve, baking it the first time it is requested.
+	 * @param PulseCurve curve driving Glow Amount (X), Fresnel Exponent (Y) and Fresnel Reflect Fraction (Z).
+	 * @param PulseCurveTime duration of one pulse; the texture covers [0, PulseCurveTime].
+	 */
+	UTexture2D* GetPulseCurveTexture(UCurveVector* PulseCurve, const float PulseCurveTime);
+
+private:
+	/** Sample the curve into a one pixel high float texture. */
+	static UTexture2D* BakePulseCurveTexture(const UCurveVector* PulseCurve, const float PulseCurveTime);
+
+	/** Number of curve samples stored in each lookup texture. */
+	static constexpr int32 PulseTextureWidth = 64;
+
+	/** Baked textures, keyed by curve and pulse duration. */
+	TMap<TPair<const UCurveVector*, float>, UTexture2D*> PulseTextureLookup;
+
+	/** Keeps the baked textures alive. */
+	UPROPERTY(Transient)
+	TArray<UTexture2D*> PulseTextures;
+};
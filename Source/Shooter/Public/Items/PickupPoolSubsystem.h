@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupPoolSubsystem.generated.h"
+
+class AItem;
+
+/** Pickups spawned up front for a class. Configured in the [/Script/Shooter.PickupPoolSubsystem] section of DefaultGame.ini. */
+USTRUCT()
+struct FPickupPoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftClassPtr<AItem> ItemClass;
+
+	UPROPERTY(EditAnywhere)
+	int32 Count = 0;
+};
+
+/** Parked pickups of one class and the counters of the class. */
+USTRUCT()
+struct FPickupPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AItem*> FreeItems;
+
+	/** Acquires served from FreeItems. */
+	int32 Hits = 0;
+
+	/** Acquires that had to spawn a new actor. */
+	int32 Misses = 0;
+
+	/** Time spent spawning actors of the class, prewarming included. */
+	double SpawnSeconds = 0.0;
+
+	int32 SpawnCount = 0;
+
+	/** Spawn time saved by the hits, estimated from the average spawn time. */
+	double SecondsAvoided = 0.0;
+};
+
+/**
+ * Recycles ammo pickups instead of spawning and destroying them.
+ * Weapons are not pooled: a dropped weapon stays in the world as a pickup, so it is never released.
+ * Released items are hidden, lose their collision and tick, and are reset through AItem::OnAcquiredFromPool when reused.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UPickupPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Spawn the pickups listed in Prewarm. Called once the world has begun play. */
+	void PrewarmConfiguredPools();
+
+	/** Spawn Count parked pickups of the class. */
+	void Prewarm(TSubclassOf<AItem> ItemClass, const int32 Count);
+
+	/** Take a pickup of the class out of the pool, or spawn one if the pool is empty, and place it at the transform in the Pickup state. */
+	AItem* AcquireItem(TSubclassOf<AItem> ItemClass, const FTransform& Transform);
+
+	template<class T>
+	T* Acquire(TSubclassOf<T> ItemClass, const FTransform& Transform)
+	{
+		return Cast<T>(AcquireItem(ItemClass, Transform));
+	}
+
+	/** Park the pickup for reuse. */
+	void ReleaseItem(AItem* Item);
+
+	/** Log the hits, misses and spawn time avoided of every pool. */
+	void DumpStats() const;
+
+private:
+	/** Spawn an actor of the class and time it. */
+	AItem* SpawnItem(UClass* ItemClass, const FTransform& Transform, FPickupPool& Pool) const;
+
+	/** Pickups to spawn when the world begins play. */
+	UPROPERTY(Config)
+	TArray<FPickupPoolPrewarm> PrewarmPools;
+
+	UPROPERTY()
+	TMap<UClass*, FPickupPool> Pools;
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Shooter/Public/Items/Weapon.h"
+#include "Shotgun.generated.h"
+
+/**
+ * Weapon firing several pellets per shot, spread in a cone around the aim.
+ * Pellet count and spread come from the Shotgun row of the weapon data table.
+ */
+UCLASS()
+class SHOOTER_API AShotgun : public AWeapon
+{
+	GENERATED_BODY()
+
+public:
+	AShotgun();
+
+	/**
+	 * Fill the directions of the pellets of one shot in a single pass around a shared basis.
+	 * The spread follows a seeded stream, so runs with the same seed fire the same patterns.
+	 * @param AimDirection normalized direction of the crosshairs.
+	 * @param OutDirections one normalized direction per pellet, sized to GetPelletCount.
+	 */
+	void GeneratePelletDirections(const FVector& AimDirection, TArrayView<FVector> OutDirections);
+
+	FORCEINLINE int32 GetPelletCount() const { return FMath::Max(1, PelletCount); }
+
+protected:
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	virtual void BeginPlay() override;
+
+private:
+	/** Pellets per shot. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shotgun", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 PelletCount;
+
+	/** Half angle in degrees of the spread cone. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shotgun", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "45.0"))
+	float PelletSpreadAngle;
+
+	/** Seed of the spread; 0 picks a new seed every time the shotgun is spawned. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shotgun", meta = (AllowPrivateAccess = "true"))
+	int32 SpreadSeed;
+
+	FRandomStream SpreadStream;
+};
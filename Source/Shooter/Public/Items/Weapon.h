@@ -6,6 +6,8 @@
 #include "Item.h"
 #include "Shooter/Library/WeaponTypeEnumLibrary.h"
 #include "Shooter/Library/AmmoTypeEnumLibrary.h"
+#include "Shooter/Library/FireModeEnumLibrary.h"
+#include "Shooter/Library/HitZoneEnumLibrary.h"
 #include "Weapon.generated.h"
 
 UCLASS()
@@ -34,6 +36,7 @@ public:
 	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
 
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
+	FORCEINLINE void SetWeaponType(const EWeaponType Type) { WeaponType = Type; }
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
 
 	FORCEINLINE void SetReloadMontageSection(const FName Name) { ReloadMontageSection = Name; }
@@ -45,11 +48,20 @@ public:
 	FORCEINLINE UParticleSystem* GetMuzzleFlash() const { return MuzzleFlash; }
 	FORCEINLINE USoundCue* GetFireSound() const { return FireSound; }
 	FORCEINLINE bool GetAutomatic() const { return bAutomatic; }
+	FORCEINLINE EFireMode GetFireMode() const { return FireMode; }
+	FORCEINLINE float GetMuzzleVelocity() const { return MuzzleVelocity; }
+	FORCEINLINE float GetProjectileGravityScale() const { return ProjectileGravityScale; }
 
 	FORCEINLINE float GetDamage() const { return Damage; }
 	FORCEINLINE float GetHeadShotDamage() const { return HeadShotDamage; }
+
+	/** Returns the damage of a bullet hitting the zone. */
+	float GetZoneDamage(const EHitZone HitZone) const;
 	
 	bool ClipIsFull() const;
+
+	/** Also refills the ammo from the weapon data. */
+	virtual void OnAcquiredFromPool() override;
 	
 protected:
 	virtual void OnConstruction(const FTransform& Transform) override;
@@ -61,6 +73,9 @@ protected:
 	void UpdateSlideDisplacement();
 	
 	void StopFalling();
+
+	/** Weapons also tick while falling and equipped to update the mesh rotation and pistol slide. */
+	virtual bool ShouldTickInState(const EItemState State) const override;
 	
 private:
 	FTimerHandle ThrowWeaponTimer;
@@ -176,4 +191,19 @@ private:
 	/** Amount of damage when bullet hits the head. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	float HeadShotDamage;
+
+	/** Whether bullets are hitscan traces or ballistic projectiles. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	EFireMode FireMode;
+
+	/** Speed of ballistic bullets when they leave the barrel, in cm/s. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float MuzzleVelocity;
+
+	/** Multiplier of the world gravity on ballistic bullets. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float ProjectileGravityScale;
+
+	/** Damage by EHitZone, built from the weapon data; empty when the weapon has no data row. */
+	TArray<float> ZoneDamage;
 };
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EffectPoolSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/** Pool size for one effect. Configured in the [/Script/Shooter.EffectPoolSubsystem] section of DefaultGame.ini. */
+USTRUCT()
+struct FEffectPoolSize
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftObjectPtr<UParticleSystem> Template;
+
+	/** Maximum finished components kept around for reuse. */
+	UPROPERTY(EditAnywhere)
+	int32 MaxPoolSize = 16;
+};
+
+/** Components of one effect that finished playing and wait to be reused, and the counters of the effect. */
+USTRUCT()
+struct FEffectPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> FreeComponents;
+
+	int32 MaxPoolSize = 0;
+
+	/** Components currently playing. */
+	int32 LiveCount = 0;
+
+	int32 PeakLiveCount = 0;
+
+	/** Spawns served from FreeComponents. */
+	int32 Hits = 0;
+
+	/** Spawns that had to create a new component. */
+	int32 Misses = 0;
+};
+
+/**
+ * Spawns one shot particle effects from pools of components kept per UParticleSystem.
+ * A component goes back to its pool when the effect finishes, so looping effects must not be spawned through here.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UEffectPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Play the effect at the transform, reusing a finished component when one is available.
+	 * @return the playing component, only valid until the effect finishes.
+	 */
+	UParticleSystemComponent* SpawnEffect(UParticleSystem* Template, const FTransform& Transform);
+
+	/** Play the effect at the location with the rotation. */
+	UParticleSystemComponent* SpawnEffectAtLocation(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	/** Log the hits, misses and peak live components of every pool. */
+	void DumpStats() const;
+
+private:
+	/** Put the component back into its pool, or destroy it if the pool is full. */
+	UFUNCTION()
+	void OnEffectFinished(UParticleSystemComponent* Component);
+
+	/** Create a component for the template, registered with the world and released to the pool when it finishes. */
+	UParticleSystemComponent* CreateComponent(UParticleSystem* Template);
+
+	/** Find or add the pool of the template. */
+	FEffectPool& GetPool(UParticleSystem* Template);
+
+	/** Pool sizes of specific effects. */
+	UPROPERTY(Config)
+	TArray<FEffectPoolSize> PoolSizes;
+
+	/** Pool size of effects not listed in PoolSizes. */
+	UPROPERTY(Config)
+	int32 DefaultMaxPoolSize = 16;
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FEffectPool> Pools;
+
+	/** PoolSizes by effect path. */
+	TMap<FSoftObjectPath, int32> MaxPoolSizeByPath;
+
+	/** Components playing across every pool. */
+	int32 TotalLiveCount = 0;
+
+	int32 PeakTotalLiveCount = 0;
+};
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TelemetrySubsystem.generated.h"
+
+class AEnemy;
+
+/** Whether telemetry is recorded; set through Shooter.Telemetry.Enable. */
+extern SHOOTER_API bool GShooterTelemetryEnabled;
+
+/** Kind of a telemetry record. */
+UENUM()
+enum class ETelemetryEvent : uint8
+{
+	ETE_ShotFired UMETA(DisplayName = "ShotFired"),
+	ETE_TraceIssued UMETA(DisplayName = "TraceIssued"),
+	ETE_DamageEvent UMETA(DisplayName = "DamageEvent"),
+	ETE_Explosion UMETA(DisplayName = "Explosion"),
+	ETE_ItemTick UMETA(DisplayName = "ItemTick"),
+	ETE_EnemiesAlive UMETA(DisplayName = "EnemiesAlive"),
+	ETE_WidgetsAlive UMETA(DisplayName = "WidgetsAlive"),
+
+	ETE_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/** Fixed size record of the telemetry ring buffer. */
+struct FTelemetryRecord
+{
+	/** FPlatformTime::Seconds when the record was pushed. */
+	double Seconds;
+
+	/** GFrameCounter when the record was pushed. */
+	uint32 Frame;
+
+	/** Damage amount for damage events, the count for traces and gauges, 1 otherwise. */
+	float Value;
+
+	ETelemetryEvent Event;
+};
+
+/**
+ * In-memory ring buffer of gameplay events, for frame diagnostics in any build.
+ * Records can be pushed from any thread without locks; the oldest records are overwritten when the buffer is full.
+ * Once per frame the subsystem also pushes gauges for the enemies alive and the hit number widgets on screen,
+ * counted from the registered enemies and the player HUDs so that sampling does not walk the object array.
+ * Recording is off until Shooter.Telemetry.Enable is set, and costs a single branch while off.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UTelemetrySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UTelemetrySubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Push a record to the telemetry of the world, if telemetry is enabled. Thread safe.
+	 * @param World world the event happened in.
+	 * @param Event kind of the event.
+	 * @param Value damage amount, number of traces or gauge count; 1 for plain events.
+	 */
+	static FORCEINLINE void Record(const UWorld* World, const ETelemetryEvent Event, const float Value = 1.f)
+	{
+		if (GShooterTelemetryEnabled)
+		{
+			RecordEnabled(World, Event, Value);
+		}
+	}
+
+	/** Count the enemy in the enemies alive gauge until it is destroyed. */
+	void RegisterEnemy(AEnemy* Enemy);
+
+	/** Push a record to this ring buffer. Thread safe. */
+	void Push(const ETelemetryEvent Event, const float Value);
+
+	/**
+	 * Write the records of the last seconds to a CSV file in Saved/Telemetry, one row per frame.
+	 * @param Seconds how far back to dump.
+	 * @return path of the written file, empty if it could not be written.
+	 */
+	FString DumpToCsv(const float Seconds) const;
+
+private:
+	/** Slot of the ring buffer. Sequence is the record index plus one once written, 0 while being written. */
+	struct FTelemetrySlot
+	{
+		volatile int64 Sequence;
+		FTelemetryRecord Record;
+	};
+
+	static void RecordEnabled(const UWorld* World, const ETelemetryEvent Event, const float Value);
+
+	/** Copy the records that are still in the buffer, oldest first. */
+	void ReadRecords(TArray<FTelemetryRecord>& OutRecords) const;
+
+	/** Push the per frame gauges. */
+	void SampleGauges();
+
+	/** Records kept, rounded up to a power of two. */
+	UPROPERTY(Config)
+	int32 Capacity;
+
+	TArray<FTelemetrySlot> Slots;
+
+	/** Capacity - 1, to wrap record indices into slots. */
+	int64 IndexMask;
+
+	/** Index of the next record; only ever grows. */
+	volatile int64 WriteIndex;
+
+	/** Enemies counted by the gauges. Destroyed enemies are dropped on the next sample. */
+	TArray<TWeakObjectPtr<AEnemy>> Enemies;
+};
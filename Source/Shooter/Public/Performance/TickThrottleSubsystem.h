@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TickThrottleSubsystem.generated.h"
+
+/** Distance buckets used to throttle actor ticks, ordered from full rate to lowest rate. */
+UENUM()
+enum class ETickThrottleBucket : uint8
+{
+	ETTB_Near UMETA(DisplayName = "Near"),
+	ETTB_Mid UMETA(DisplayName = "Mid"),
+	ETTB_Far UMETA(DisplayName = "Far"),
+
+	ETTB_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/** How actors of a class are throttled. Configured in the [/Script/Shooter.TickThrottleSubsystem] section of DefaultGame.ini. */
+USTRUCT()
+struct FTickThrottlePolicy
+{
+	GENERATED_BODY()
+
+	/** Class the policy applies to. Subclasses use the policy of their closest configured parent. */
+	UPROPERTY(EditAnywhere)
+	TSoftClassPtr<AActor> ActorClass;
+
+	/** Actors closer than this tick at their own rate. */
+	UPROPERTY(EditAnywhere)
+	float NearDistance = 1500.f;
+
+	/** Actors further than this are in the far bucket. */
+	UPROPERTY(EditAnywhere)
+	float FarDistance = 4000.f;
+
+	/** Tick interval in the mid bucket. */
+	UPROPERTY(EditAnywhere)
+	float MidTickInterval = 0.1f;
+
+	/** Tick interval in the far bucket. */
+	UPROPERTY(EditAnywhere)
+	float FarTickInterval = 0.5f;
+
+	/** Disable tick entirely in the far bucket instead of using FarTickInterval. */
+	UPROPERTY(EditAnywhere)
+	bool bDisableTickWhenFar = false;
+
+	/** Actors that were not rendered recently are moved one bucket further away. */
+	UPROPERTY(EditAnywhere)
+	bool bDemoteWhenNotRendered = true;
+
+	/** Rough cost of one tick of this class, used to report the time saved. */
+	UPROPERTY(EditAnywhere)
+	float EstimatedTickCostMicroseconds = 5.f;
+};
+
+/**
+ * Buckets registered actors by their distance to the local AShooterCharacter and whether they were rendered,
+ * and lowers the actor tick interval or disables the actor tick for the far buckets.
+ * Only the actor tick is throttled, component ticks such as movement are left alone.
+ * Enemies have no policy: their actor tick is off, their animation is throttled through the URO bands of the mesh instead.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UTickThrottleSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
+	/** Start throttling the actor if a policy matches its class. Destroyed actors are dropped on the next bucket update. */
+	void RegisterActor(AActor* Actor);
+
+	/**
+	 * Called by actors that turned their own tick on or off, so the subsystem never turns back on a tick the actor turned off.
+	 * An actor that turns its tick on while in a far bucket that disables tick is turned off again.
+	 */
+	void OnActorTickChanged(AActor* Actor);
+
+	/** Log the bucket populations and the estimated tick time saved per policy. */
+	void DumpStats() const;
+
+private:
+	/** An actor handled by the subsystem. */
+	struct FThrottledActor
+	{
+		TWeakObjectPtr<AActor> Actor;
+
+		/** Index into Policies. */
+		int32 PolicyIndex = INDEX_NONE;
+
+		ETickThrottleBucket Bucket = ETickThrottleBucket::ETTB_Near;
+
+		/** Tick interval the actor had when it was registered. */
+		float BaseTickInterval = 0.f;
+
+		/** True while the actor tick is off because of the subsystem, so ticks disabled by the actor itself are never turned back on. */
+		bool bTickDisabledByThrottle = false;
+	};
+
+	/** Counters kept per policy for DumpStats. */
+	struct FPolicyStats
+	{
+		int32 BucketCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_MAX)] = {};
+
+		/** Actors of each bucket ticking at the interval of the bucket, so actors that turned their own tick off are left out. */
+		int32 TickingCounts[static_cast<uint8>(ETickThrottleBucket::ETTB_MAX)] = {};
+
+		/** Actors with their tick disabled by the subsystem. */
+		int32 DisabledCount = 0;
+
+		/** Ticks that would have run at full rate but did not. */
+		double TicksSkipped = 0.0;
+	};
+
+	/** Index of the most derived policy matching the class, INDEX_NONE when nothing matches. */
+	int32 FindPolicyIndex(UClass* Class);
+
+	/** Move the actors into their buckets around the viewer location. */
+	void UpdateBuckets(const FVector& ViewLocation);
+
+	/** Remove the entry by swapping the last one into its place. */
+	void RemoveThrottledActor(const int32 Index);
+
+	/** Apply the tick settings of the bucket to the actor. */
+	void ApplyBucket(FThrottledActor& Entry, ETickThrottleBucket NewBucket);
+
+	/** Give the actor back its own tick settings. */
+	static void RestoreActor(FThrottledActor& Entry);
+
+	/** Returns true if the actor itself wants to tick right now, asked before a tick disabled by the subsystem is turned back on. */
+	static bool ActorWantsTick(const AActor* Actor);
+
+	/** Add up the ticks skipped this frame. */
+	void AccumulateSkippedTicks(float DeltaTime);
+
+	/** Per class throttling policies. */
+	UPROPERTY(Config)
+	TArray<FTickThrottlePolicy> Policies;
+
+	/** Seconds between bucket updates. */
+	UPROPERTY(Config)
+	float BucketUpdateInterval = 0.25f;
+
+	/** How long after its last render an actor still counts as visible. */
+	UPROPERTY(Config)
+	float RecentlyRenderedTolerance = 0.5f;
+
+	/** Policy classes loaded from Policies, same order. */
+	UPROPERTY()
+	TArray<UClass*> PolicyClasses;
+
+	/** Actors handled by the subsystem. */
+	TArray<FThrottledActor> ThrottledActors;
+
+	/** Index into ThrottledActors of every registered actor. */
+	TMap<TWeakObjectPtr<AActor>, int32> ThrottledActorIndices;
+
+	/** Policy index found for every class registered so far. */
+	TMap<UClass*, int32> PolicyIndexByClass;
+
+	/** Counters for each entry of Policies. */
+	TArray<FPolicyStats> PolicyStats;
+
+	/** Seconds until the next bucket update. */
+	float TimeUntilBucketUpdate = 0.f;
+
+	/** Seconds the subsystem has been collecting stats. */
+	double TrackedTime = 0.0;
+
+	/** Throttling was active on the previous tick. */
+	bool bWasEnabled = true;
+};
@@ -4,12 +4,54 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "Shooter/Library/OffsetStateEnumLibrary.h"
 #include "Shooter/Library/WeaponTypeEnumLibrary.h"
+#include "Shooter/Public/Animation/AnimCurveHandleCache.h"
 #include "ShooterAnimInstance.generated.h"
 
 class AShooterCharacter;
 
+/** Character state read by the animation update, copied on the game thread so the update itself can run on a worker thread. */
+struct FShooterAnimSnapshot
+{
+	FVector Velocity;
+	FRotator AimRotation;
+	FRotator ActorRotation;
+	EWeaponType EquippedWeaponType;
+	bool bHasEquippedWeapon;
+	bool bCrouching;
+	bool bReloading;
+	bool bEquipping;
+	bool bIsInAir;
+	bool bIsAccelerating;
+	bool bAiming;
+	bool bShouldUseFABRIK;
+
+	/** Turn in place curves as evaluated last frame; the anim instance curve map is not read off the game thread. */
+	float TurningCurveValue;
+	float RotationCurveValue;
+};
+
+/**
+ * Proxy of UShooterAnimInstance.
+ * PreUpdate copies the character state and the turn in place curves on the game thread and Update runs the yaw, lean and recoil math during the parallel animation update.
+ */
+struct FShooterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	explicit FShooterAnimInstanceProxy(UAnimInstance* InAnimInstance);
+
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	FShooterAnimSnapshot Snapshot;
+
+	/** False when there is no character or the game thread update is used instead. */
+	bool bHasSnapshot;
+};
+
 UCLASS()
 class SHOOTER_API UShooterAnimInstance : public UAnimInstance
 {
@@ -27,14 +69,36 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void UpdateAnimationProperties(const float DeltaTime);
 
+	/**
+	 * Time the game thread cost of the update with and without the worker thread path.
+	 * The turn in place and lean state carried between frames is restored afterwards.
+	 * @param Iterations number of updates to time.
+	 * @param OutGameThreadUpdateSeconds time spent by the full update on the game thread.
+	 * @param OutSnapshotSeconds time spent by the snapshot only, which is all the worker thread path leaves on the game thread.
+	 */
+	void RunUpdateBenchmark(const int32 Iterations, double& OutGameThreadUpdateSeconds, double& OutSnapshotSeconds);
+
+	/** Returns true if the update runs in the proxy instead of from the event graph. */
+	static bool IsThreadSafeUpdateEnabled();
+
 protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+
 	/** Handle turning in place variables. */
-	void TurnInPlace();
+	void TurnInPlace(const FShooterAnimSnapshot& Snapshot);
 
 	/** Handle calculation for leaning while running. */
-	void Lean(float DeltaTime);
+	void Lean(const FShooterAnimSnapshot& Snapshot, float DeltaTime);
 	
 private:
+	friend struct FShooterAnimInstanceProxy;
+
+	/** Copy the character state used by the update. Game thread only. */
+	void TakeSnapshot(FShooterAnimSnapshot& OutSnapshot) const;
+
+	/** Update the animation properties from the snapshot. Safe to call from a worker thread. */
+	void UpdateFromSnapshot(const FShooterAnimSnapshot& Snapshot, const float DeltaTime);
+
 	/** Returns true if the character is crouching. */
 	bool IsCharacterCrouching() const;
 	
@@ -57,12 +121,13 @@ private:
 
 	/**
 	* Set the lateral speed of the character from the velocity.
+	* @param Velocity velocity of the character.
 	* @param CharacterSpeed passing by reference and setting the speed value.
 	*/
-	void SetCharacterSpeed(float& CharacterSpeed) const;
+	static void SetCharacterSpeed(const FVector& Velocity, float& CharacterSpeed);
 
 	/** Calculate MovementOffsetYaw for running blendspace. */
-	void CalculateMovementOffsetYaw();
+	void CalculateMovementOffsetYaw(const FShooterAnimSnapshot& Snapshot);
 
 	/** Set Offset state. */
 	void SetOffsetState();
@@ -113,6 +178,15 @@ private:
 	/** Rotation curve value last frame. */
 	float RotationCurveLastFrame;
 
+	/** Turn in place curves, resolved in NativeInitializeAnimation. */
+	FAnimCurveHandleCache CurveCache;
+
+	/** 1.0 while a turn in place animation plays. */
+	int32 TurningCurveHandle;
+
+	/** Accumulated rotation of the turn in place animation. */
+	int32 RotationCurveHandle;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Turn in Place", meta=(AllowPrivateAccess = "true"))
 	float Pitch;
 
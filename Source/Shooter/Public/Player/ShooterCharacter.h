@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "WorldCollision.h"
 #include "Shooter/Library/AmmoTypeEnumLibrary.h"
 #include "Shooter/Library/CombatStateEnumLibrary.h"
 #include "ShooterCharacter.generated.h"
@@ -14,6 +15,7 @@ class USoundCue;
 class UParticleSystem;
 class AItem;
 class AWeapon;
+struct FHitscanShot;
 
 USTRUCT(BlueprintType)
 struct FInterpLocation
@@ -70,6 +72,10 @@ public:
 	FORCEINLINE UParticleSystem* GetBloodParticles() const { return BloodParticles; }
 
 	FORCEINLINE float GetStunChance() const { return StunChance; }
+
+	/** Number of bullets sent and the time spent sending them, used by the gameplay benchmark. */
+	FORCEINLINE int32 GetBulletsSent() const { return BulletsSent; }
+	FORCEINLINE double GetSendBulletSeconds() const { return SendBulletSeconds; }
 	
 	FInterpLocation GetInterpolationLocation(const int32 Index);
 
@@ -92,6 +98,17 @@ public:
 	void UnHighlightInventorySlot();
 	
 	void Stun();
+
+	/**
+	 * Called by the UHitscanSubsystem once the traces of a shot fired by this character are resolved.
+	 * Also called by the UProjectileSubsystem when a ballistic bullet of this character hits something.
+	 * @param Shots the single shot, or every pellet of a blast; hits on the same enemy are merged into one damage event.
+	 * @param Weapon weapon the shots were fired with; the equipped weapon when null.
+	 */
+	void ApplyHitscanShots(TArrayView<const FHitscanShot> Shots, const AWeapon* Weapon = nullptr);
+
+	/** Press or release the fire button from code, e.g. for scripted benchmarks. */
+	void SetFireButtonPressed(const bool bPressed);
 	
 protected:
 	virtual void BeginPlay() override;
@@ -128,8 +145,11 @@ protected:
 
 	virtual void Jump() override;
 	
-	/** Called when the fire button is pressed. */
-	void FireWeapon();
+	/**
+	 * Called when the fire button is pressed, and for every automatic shot that comes due.
+	 * @param FrameAlpha when in the frame the shot was due, from 0 at the previous tick to 1 at this one.
+	 */
+	void FireWeapon(const float FrameAlpha = 1.f);
 	
 	/** Calculate crosshair spread amount value. */
 	void CalculateCrosshairSpread(const float DeltaTime);
@@ -142,10 +162,20 @@ protected:
 	void FireButtonPressed();
 	void FireButtonReleased();
 
+	/** Wait AutoFireRate before the next shot, carrying over the part of the frame already elapsed. */
 	void StartFireTimer();
 	
-	UFUNCTION()
-	void AutoFireReset();
+	/** End the wait after a shot and fire again if automatic fire is held. */
+	void AutoFireReset(const float FrameAlpha = 1.f);
+
+	/**
+	 * Count down the wait between shots and fire every shot that came due during the frame,
+	 * so the rate of fire does not depend on the frame rate.
+	 */
+	void UpdateAutoFire(const float DeltaTime);
+
+	/** Remember the muzzle and crosshairs while a burst goes on. */
+	void RecordFireAim();
 
 	/** Bound to the R key. */
 	void ReloadButtonPressed();
@@ -164,12 +194,18 @@ protected:
 	
 	void CrouchButtonPressed();
 	
-	/** Line Trace for items under the crosshairs. */
-	bool TraceUnderCrosshairs(FHitResult& OutHitResult);
-
-	/** Trace for items if OverlappedItemCount > 0. */
+	/** Request an async trace for items under the crosshairs if OverlappedItemCount > 0. */
 	void TraceForItems();
 
+	/** Called next frame with the result of the async trace requested in TraceForItems. */
+	void OnItemTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/**
+	 * Update the item under the crosshairs; widget and custom depth are only toggled when it changes.
+	 * @param HitItem item hit by the trace (could be null).
+	 */
+	void UpdateTraceHitItem(AItem* HitItem);
+
 	/** Spawns a default weapon and equips it. */
 	AWeapon* SpawnDefaultWeapon() const;
 
@@ -226,11 +262,11 @@ private:
 	/** Playing fire sound cue when character starts firing. */
 	void PlayFireSoundCue() const;
 
-	/** FireWeapon Functions. */
-	void SendBullet();
-	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult);
-	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
-
+	/**
+	 * Queue the trace of a shot with the UHitscanSubsystem.
+	 * @param FrameAlpha shots due earlier in the frame are fired from between the previous and the current aim.
+	 */
+	void SendBullet(const float FrameAlpha = 1.f);
 	
 	/** Play fire weapon animation montage when character starts firing. */
 	void PlayFireAnimMontage();
@@ -404,13 +440,33 @@ private:
 	/** True when we can fire. False waiting for the timer. */
 	bool bShouldFire;
 	
-	/** Sets a timer between gunshots. */
-	FTimerHandle AutoFireTimer;
+	/** Seconds until the next shot is due; negative when it came due during the frame. */
+	float AutoFireCooldown;
+
+	/** Muzzle and crosshairs at the end of the previous frame of a burst. */
+	FTransform PreviousMuzzleTransform;
+	FVector PreviousCrosshairPosition;
+	FVector PreviousCrosshairDirection;
+
+	/** GFrameCounter when the previous aim was recorded. */
+	uint64 PreviousAimFrame;
+
+	/** GFrameCounter when a press armed the cooldown before this tick; that frame's DeltaTime passed before the press. */
+	uint64 AutoFireArmedFrame;
+
+	/** True while UpdateAutoFire fires the shots that came due. */
+	bool bUpdatingAutoFire;
 	
 	float ShootTimeDuration;
 
 	bool bFiringBullet;
 
+	/** Bullets sent since the character was spawned. */
+	int32 BulletsSent;
+
+	/** Time spent in SendBullet since the character was spawned; only covers queueing the shots, not resolving them. */
+	double SendBulletSeconds;
+
 	FTimerHandle  CrosshairShootTimer;
 
 	/** true if we should trace every frame for item.*/
@@ -419,6 +475,12 @@ private:
 	/** Number of overlapped AItems. */
 	int8 OverlappedItemCount;
 
+	/** Handle of the item trace currently in flight. */
+	FTraceHandle ItemTraceHandle;
+
+	/** Delegate receiving the async item trace results. */
+	FTraceDelegate ItemTraceDelegate;
+
 	/** The AItem we hit last frame. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
 	AItem* TraceHitItemLastFrame;
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "HitNumberManager.generated.h"
+
+class APlayerController;
+class UHitNumberWidget;
+class UUserWidget;
+
+/** A slot of the hit number ring buffer. The widget stays with the slot and is reused for every hit shown in it. */
+USTRUCT()
+struct FHitNumberSlot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UHitNumberWidget* Widget = nullptr;
+
+	/** World location of the hit. */
+	FVector Location = FVector::ZeroVector;
+
+	/** World time when the hit number is hidden. */
+	float ExpireTime = 0.f;
+};
+
+/** A hit number widget created by an enemy blueprint, used while no UHitNumberWidget class is set. */
+USTRUCT()
+struct FBlueprintHitNumber
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UUserWidget* Widget = nullptr;
+
+	/** World location of the hit. */
+	FVector Location = FVector::ZeroVector;
+
+	/** World time when the widget is removed. */
+	float ExpireTime = 0.f;
+};
+
+/**
+ * Shows hit numbers for a player controller. Widgets are created once per slot of a fixed size ring buffer
+ * and then only hidden and shown again, so firing at enemies never creates or destroys widgets once the buffer is warm.
+ * Screen positions are updated by the owning AShooterHUD in one pass per frame.
+ * Every hit number has the same display time, so the oldest entry is always at the head of the buffer
+ * and is the one recycled when the buffer is full.
+ * Without a widget class the enemies create their own blueprint widgets; those are only placed and removed here.
+ */
+UCLASS()
+class SHOOTER_API UHitNumberManager : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UHitNumberManager();
+
+	/**
+	 * Set up the ring buffer.
+	 * @param InPlayerController owner of the widgets and the view to project hit locations with.
+	 * @param InWidgetClass widget to show for every hit.
+	 * @param MaxHitNumbers maximum hit numbers on screen at the same time.
+	 * @param InDisplayTime time a hit number stays on screen.
+	 */
+	void Initialize(APlayerController* InPlayerController, TSubclassOf<UHitNumberWidget> InWidgetClass, const int32 MaxHitNumbers, const float InDisplayTime);
+
+	/** Show the damage of a hit at the hit location, replacing the oldest hit number when the buffer is full. */
+	void ShowHitNumber(const int32 Damage, const FVector& Location, const bool bHeadShot);
+
+	/** Place a widget created by an enemy blueprint at the hit location and remove it from its parent after the display time. */
+	void AddBlueprintHitNumber(UUserWidget* Widget, const FVector& Location);
+
+	/**
+	 * Hide expired hit numbers and move the active ones to the screen position of their hit location.
+	 * @param ViewProjectionMatrix view projection of the player, computed once for all hit numbers.
+	 * @param ViewRect viewport area of the player.
+	 */
+	void UpdateHitNumbers(const FMatrix& ViewProjectionMatrix, const FIntRect& ViewRect);
+
+	/** False when the hit numbers are left to the enemy blueprints. */
+	FORCEINLINE bool UsesPooledWidgets() const { return WidgetClass != nullptr; }
+	FORCEINLINE bool HasActiveHitNumbers() const { return ActiveCount > 0 || BlueprintHitNumbers.Num() > 0; }
+	FORCEINLINE int32 GetNumActiveHitNumbers() const { return ActiveCount + BlueprintHitNumbers.Num(); }
+
+private:
+	/** Create the widget of the slot if it does not exist yet. */
+	UHitNumberWidget* GetOrCreateWidget(FHitNumberSlot& Slot) const;
+
+	UPROPERTY()
+	APlayerController* PlayerController;
+
+	UPROPERTY()
+	TSubclassOf<UHitNumberWidget> WidgetClass;
+
+	/** Ring buffer of hit numbers. */
+	UPROPERTY()
+	TArray<FHitNumberSlot> Slots;
+
+	/** Index of the oldest active slot. */
+	int32 Head;
+
+	/** Number of active slots. */
+	int32 ActiveCount;
+
+	/** Widgets created by enemy blueprints, oldest first. */
+	UPROPERTY()
+	TArray<FBlueprintHitNumber> BlueprintHitNumbers;
+
+	float DisplayTime;
+};
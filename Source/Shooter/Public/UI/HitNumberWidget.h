@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HitNumberWidget.generated.h"
+
+/**
+ * Widget showing the damage of a single hit. Instances are pooled by UHitNumberManager,
+ * so the widget is set up again through SetHitNumber every time it is reused.
+ */
+UCLASS(Abstract)
+class SHOOTER_API UHitNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Display the damage of a new hit, restarting any animation of the previous one. */
+	UFUNCTION(BlueprintImplementableEvent)
+	void SetHitNumber(const int32 Damage, const bool bHeadShot);
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "ShooterHUD.generated.h"
+
+class UHitNumberManager;
+class UHitNumberWidget;
+
+/**
+ * HUD of the shooter player. Owns the hit number pool and places every active hit number on screen
+ * in a single pass per frame, right before Slate paints the widgets.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API AShooterHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	AShooterHUD();
+
+	virtual void DrawHUD() override;
+
+	FORCEINLINE UHitNumberManager* GetHitNumberManager() const { return HitNumberManager; }
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	/**
+	 * Widget pooled to display the damage of a hit; a blueprint of UHitNumberWidget.
+	 * Unset by default, until WBP_HitNumber is reparented to UHitNumberWidget the enemy blueprints create the hit numbers.
+	 */
+	UPROPERTY(Config)
+	TSoftClassPtr<UHitNumberWidget> HitNumberWidgetClass;
+
+	/** Maximum hit numbers on screen at the same time, the oldest one is reused above this. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Widgets", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxHitNumbers;
+
+	/** Time before a hit number is removed from the screen. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Widgets", meta = (AllowPrivateAccess = "true"))
+	float HitNumberDisplayTime;
+
+	/** Pools the hit number widgets of the owning player. */
+	UPROPERTY(Transient)
+	UHitNumberManager* HitNumberManager;
+};
@@ -3,9 +3,25 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
 
 #define EPS_METAL EPhysicalSurface::SurfaceType1
 #define EPS_STONE EPhysicalSurface::SurfaceType2
 #define EPS_TILE EPhysicalSurface::SurfaceType3
 #define EPS_GRASS EPhysicalSurface::SurfaceType4
 #define EPS_WATER EPhysicalSurface::SurfaceType5
+
+/** Stat group for gameplay systems of the Shooter module, shown with "stat Shooter". */
+DECLARE_STATS_GROUP(TEXT("Shooter"), STATGROUP_Shooter, STATCAT_Advanced);
+
+/**
+ * Cycle stat scope that also shows up as a CPU event in Unreal Insights.
+ * Stats are compiled out of Test and Shipping builds; the trace event is kept, so those builds can still be profiled.
+ */
+#define SHOOTER_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+
+/** General log category of the Shooter module. */
+DECLARE_LOG_CATEGORY_EXTERN(LogShooter, Log, All);